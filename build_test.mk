@@ -49,8 +49,14 @@ endif
 
 include common_features.mk
 include $(TMK_PATH)/common.mk
+include $(QUANTUM_PATH)/debounce/tests/rules.mk
+include $(QUANTUM_PATH)/pca9555_matrix/tests/rules.mk
+include $(QUANTUM_PATH)/pin_group/tests/rules.mk
+include $(QUANTUM_PATH)/scan_governor/tests/rules.mk
 include $(QUANTUM_PATH)/sequencer/tests/rules.mk
 include $(QUANTUM_PATH)/serial_link/tests/rules.mk
+include $(QUANTUM_PATH)/tests/rules.mk
+include $(TMK_PATH)/common/tests/rules.mk
 ifneq ($(filter $(FULL_TESTS),$(TEST)),)
 include build_full_test.mk
 endif
@@ -426,6 +426,10 @@ ifeq ($(strip $(USB_HID_ENABLE)), yes)
     include $(TMK_DIR)/protocol/usb_hid.mk
 endif
 
+ifeq ($(strip $(SEND_STRING_ASYNC_ENABLE)), yes)
+    OPT_DEFS += -DSEND_STRING_ASYNC_ENABLE
+endif
+
 ifeq ($(strip $(WPM_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/wpm.c
     OPT_DEFS += -DWPM_ENABLE
@@ -441,11 +445,24 @@ ifeq ($(strip $(VELOCIKEY_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/velocikey.c
 endif
 
+ifeq ($(strip $(RAW_TEXT_ENABLE)), yes)
+    RAW_ENABLE := yes
+    SRC += $(QUANTUM_DIR)/raw_text.c
+    OPT_DEFS += -DRAW_TEXT_ENABLE
+endif
+
+ifeq ($(strip $(TRACE_ENABLE)), yes)
+    RAW_ENABLE := yes
+    SRC += $(QUANTUM_DIR)/trace.c
+    OPT_DEFS += -DTRACE_ENABLE
+endif
+
 ifeq ($(strip $(VIA_ENABLE)), yes)
     DYNAMIC_KEYMAP_ENABLE := yes
     RAW_ENABLE := yes
     BOOTMAGIC_ENABLE := lite
     SRC += $(QUANTUM_DIR)/via.c
+    SRC += $(QUANTUM_DIR)/via_stream.c
     OPT_DEFS += -DVIA_ENABLE
 endif
 
@@ -478,10 +495,22 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
             QUANTUM_SRC += $(QUANTUM_DIR)/split_common/matrix.c
         else
             QUANTUM_SRC += $(QUANTUM_DIR)/matrix.c
+            QUANTUM_SRC += $(QUANTUM_DIR)/pin_group/pin_group.c
         endif
     endif
 endif
 
+ifeq ($(strip $(PCA9555_MATRIX_ENABLE)), yes)
+    ifneq ($(strip $(CUSTOM_MATRIX)), lite)
+        $(error PCA9555_MATRIX_ENABLE requires CUSTOM_MATRIX = lite)
+    endif
+    COMMON_VPATH += $(DRIVER_PATH)/gpio
+    COMMON_VPATH += $(QUANTUM_PATH)/pca9555_matrix
+    SRC += pca9555.c
+    QUANTUM_SRC += $(QUANTUM_DIR)/pca9555_matrix/pca9555_matrix.c
+    QUANTUM_LIB_SRC += i2c_master.c
+endif
+
 # Support for translating old names to new names:
 ifeq ($(strip $(DEBOUNCE_TYPE)),sym_g)
     DEBOUNCE_TYPE:=sym_defer_g
@@ -498,6 +527,19 @@ DEBOUNCE_DIR:= $(QUANTUM_DIR)/debounce
 DEBOUNCE_TYPE?= sym_defer_g
 ifneq ($(strip $(DEBOUNCE_TYPE)), custom)
     QUANTUM_SRC += $(DEBOUNCE_DIR)/$(strip $(DEBOUNCE_TYPE)).c
+    # The built-in matrix scans report raw changes, and the built-in debouncers are
+    # only active while they have changes to push, so keyboard_task() can trust both
+    ifneq ($(strip $(CUSTOM_MATRIX)), yes)
+        OPT_DEFS += -DDEBOUNCE_TRACKS_CHANGES
+    endif
+endif
+
+ifeq ($(strip $(SCAN_GOVERNOR_ENABLE)), yes)
+    ifeq ($(strip $(MATRIX_SCAN_THREAD_ENABLE)), yes)
+        $(error SCAN_GOVERNOR_ENABLE can't be used with MATRIX_SCAN_THREAD_ENABLE)
+    endif
+    OPT_DEFS += -DSCAN_GOVERNOR_ENABLE
+    SRC += $(QUANTUM_DIR)/scan_governor/scan_governor.c
 endif
 
 ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
@@ -581,6 +623,7 @@ ifeq ($(strip $(UNICODE_ENABLE)), yes)
 endif
 
 ifeq ($(strip $(UNICODE_COMMON)), yes)
+    OPT_DEFS += -DUNICODE_COMMON_ENABLE
     SRC += $(QUANTUM_DIR)/process_keycode/process_unicode_common.c
 endif
 
@@ -21,17 +21,6 @@
 #define SLAVE_TO_ADDR(n) (n << 1)
 #define TIMEOUT 100
 
-enum {
-    CMD_INPUT_0 = 0,
-    CMD_INPUT_1,
-    CMD_OUTPUT_0,
-    CMD_OUTPUT_1,
-    CMD_INVERSION_0,
-    CMD_INVERSION_1,
-    CMD_CONFIG_0,
-    CMD_CONFIG_1,
-};
-
 void pca9555_init(uint8_t slave_addr) {
     static uint8_t s_init = 0;
     if (!s_init) {
@@ -47,7 +36,7 @@ void pca9555_init(uint8_t slave_addr) {
 
 void pca9555_set_config(uint8_t slave_addr, uint8_t port, uint8_t conf) {
     uint8_t addr = SLAVE_TO_ADDR(slave_addr);
-    uint8_t cmd  = port ? CMD_CONFIG_1 : CMD_CONFIG_0;
+    uint8_t cmd  = port ? PCA9555_CMD_CONFIG_1 : PCA9555_CMD_CONFIG_0;
 
     i2c_status_t ret = i2c_writeReg(addr, cmd, &conf, sizeof(conf), TIMEOUT);
     if (ret != I2C_STATUS_SUCCESS) {
@@ -57,7 +46,7 @@ void pca9555_set_config(uint8_t slave_addr, uint8_t port, uint8_t conf) {
 
 void pca9555_set_output(uint8_t slave_addr, uint8_t port, uint8_t conf) {
     uint8_t addr = SLAVE_TO_ADDR(slave_addr);
-    uint8_t cmd  = port ? CMD_OUTPUT_1 : CMD_OUTPUT_0;
+    uint8_t cmd  = port ? PCA9555_CMD_OUTPUT_1 : PCA9555_CMD_OUTPUT_0;
 
     i2c_status_t ret = i2c_writeReg(addr, cmd, &conf, sizeof(conf), TIMEOUT);
     if (ret != I2C_STATUS_SUCCESS) {
@@ -67,7 +56,7 @@ void pca9555_set_output(uint8_t slave_addr, uint8_t port, uint8_t conf) {
 
 uint8_t pca9555_readPins(uint8_t slave_addr, uint8_t port) {
     uint8_t addr = SLAVE_TO_ADDR(slave_addr);
-    uint8_t cmd  = port ? CMD_INPUT_1 : CMD_INPUT_0;
+    uint8_t cmd  = port ? PCA9555_CMD_INPUT_1 : PCA9555_CMD_INPUT_0;
 
     uint8_t      data = 0;
     i2c_status_t ret  = i2c_readReg(addr, cmd, &data, sizeof(data), TIMEOUT);
@@ -87,7 +76,7 @@ uint16_t pca9555_readAllPins(uint8_t slave_addr) {
 
     data16 data;
 
-    i2c_status_t ret = i2c_readReg(addr, CMD_INPUT_0, &data.u8[0], sizeof(data), TIMEOUT);
+    i2c_status_t ret = i2c_readReg(addr, PCA9555_CMD_INPUT_0, &data.u8[0], sizeof(data), TIMEOUT);
     if (ret != I2C_STATUS_SUCCESS) {
         print("pca9555_readAllPins::FAILED\n");
     }
@@ -41,6 +41,17 @@
 #define PCA9555_PORT0 0
 #define PCA9555_PORT1 1
 
+enum {
+    PCA9555_CMD_INPUT_0 = 0,
+    PCA9555_CMD_INPUT_1,
+    PCA9555_CMD_OUTPUT_0,
+    PCA9555_CMD_OUTPUT_1,
+    PCA9555_CMD_INVERSION_0,
+    PCA9555_CMD_INVERSION_1,
+    PCA9555_CMD_CONFIG_0,
+    PCA9555_CMD_CONFIG_1,
+};
+
 #define ALL_OUTPUT 0
 #define ALL_INPUT 0xFF
 #define ALL_LOW 0
@@ -143,8 +143,6 @@ static void setup_usb(void)
 
     USB_Init();
 
-    // for Console_Task
-    USB_Device_EnableSOFEvents();
     print_set_sendchar(sendchar);
 }
 
@@ -373,6 +371,10 @@ int main(void)
     {
         ble_task();
         keyboard_task();
+        keyboard_report_task();
+#ifdef CONSOLE_ENABLE
+        Console_Task();
+#endif
 
 #ifdef RAW_ENABLE
         raw_hid_task();
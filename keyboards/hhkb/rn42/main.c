@@ -37,8 +37,6 @@ static void SetupHardware(void)
 
     USB_Init();
 
-    // for Console_Task
-    USB_Device_EnableSOFEvents();
     print_set_sendchar(sendchar_func);
 
     // SUART PD0:output, PD1:input
@@ -96,6 +94,10 @@ int main(void)
         }
 
         keyboard_task();
+        keyboard_report_task();
+#ifdef CONSOLE_ENABLE
+        Console_Task();
+#endif
 
 #if !defined(INTERRUPT_CONTROL_ENDPOINT)
         USB_USBTask();
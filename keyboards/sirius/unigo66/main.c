@@ -52,8 +52,6 @@ static void LUFA_setup(void)
 
     USB_Init();
 
-    // for Console_Task
-    USB_Device_EnableSOFEvents();
     print_set_sendchar(sendchar);
 }
 
@@ -89,6 +87,10 @@ int main(void)
 
     for (;;) {
         keyboard_task();
+        keyboard_report_task();
+#ifdef CONSOLE_ENABLE
+        Console_Task();
+#endif
 
 #if !defined(INTERRUPT_CONTROL_ENDPOINT)
         // LUFA Task for control request
@@ -43,6 +43,17 @@
 //#define MATRIX_COL_PINS { F1, F0, B0 }
 //#define UNUSED_PINS
 
+/* Rows on IC1 (0x20) port 0, columns on IC2 (0x21) */
+#define PCA9555_MATRIX_ROW_PINS \
+    { PCA9555_PIN(0x20, 0, 0), PCA9555_PIN(0x20, 0, 1), PCA9555_PIN(0x20, 0, 2), PCA9555_PIN(0x20, 0, 3), PCA9555_PIN(0x20, 0, 4), PCA9555_PIN(0x20, 0, 5) }
+#define PCA9555_MATRIX_COL_PINS \
+    { \
+        PCA9555_PIN(0x21, 0, 0), PCA9555_PIN(0x21, 0, 1), PCA9555_PIN(0x21, 0, 2), PCA9555_PIN(0x21, 0, 3), \
+        PCA9555_PIN(0x21, 0, 4), PCA9555_PIN(0x21, 0, 5), PCA9555_PIN(0x21, 0, 6), PCA9555_PIN(0x21, 0, 7), \
+        PCA9555_PIN(0x21, 1, 0), PCA9555_PIN(0x21, 1, 1), PCA9555_PIN(0x21, 1, 2), PCA9555_PIN(0x21, 1, 3), \
+        PCA9555_PIN(0x21, 1, 4), PCA9555_PIN(0x21, 1, 5), PCA9555_PIN(0x21, 1, 6) \
+    }
+
 /* COL2ROW, ROW2COL */
 //#define DIODE_DIRECTION COL2ROW
 
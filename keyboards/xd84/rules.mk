@@ -33,9 +33,6 @@ LTO_ENABLE = yes
 
 # custom matrix setup
 CUSTOM_MATRIX = lite
-
-VPATH += drivers/gpio
-SRC += pca9555.c matrix.c
-QUANTUM_LIB_SRC += i2c_master.c
+PCA9555_MATRIX_ENABLE = yes
 
 LAYOUTS = 75_ansi 75_iso
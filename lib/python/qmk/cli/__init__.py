@@ -157,3 +157,5 @@ from . import multibuild  # noqa
 from . import new  # noqa
 from . import pyformat  # noqa
 from . import pytest  # noqa
+from . import raw_text  # noqa
+from . import trace  # noqa
@@ -0,0 +1,39 @@
+"""Type text sent by the keyboard over raw HID.
+"""
+from milc import cli
+
+from qmk.raw_text import RAW_USAGE_ID, RAW_USAGE_PAGE, TextInjectionDaemon, open_device, type_text
+
+
+def _hex(value):
+    return int(value, 16)
+
+
+@cli.argument('-v', '--vid', type=_hex, help='Vendor ID of the keyboard, in hex.')
+@cli.argument('-p', '--pid', type=_hex, help='Product ID of the keyboard, in hex.')
+@cli.argument('--usage-page', type=_hex, default=RAW_USAGE_PAGE, help='Raw HID usage page, in hex.')
+@cli.argument('--usage', type=_hex, default=RAW_USAGE_ID, help='Raw HID usage, in hex.')
+@cli.subcommand('Type unicode text sent by a keyboard built with RAW_TEXT_ENABLE.')
+def raw_text(cli):
+    """Listen for text from the keyboard and type it natively.
+    """
+    try:
+        device = open_device(cli.args.vid, cli.args.pid, cli.args.usage_page, cli.args.usage)
+    except ImportError:
+        cli.log.error('The {fg_cyan}hid{fg_reset} python module is required: python3 -m pip install hid')
+        return False
+
+    if not device:
+        cli.log.error('No raw HID device found.')
+        return False
+
+    cli.log.info('Listening for text, press Ctrl-C to stop.')
+
+    def typer(text):
+        cli.log.debug('Typing %r', text)
+        type_text(text)
+
+    try:
+        TextInjectionDaemon(device, typer).run()
+    except KeyboardInterrupt:
+        pass
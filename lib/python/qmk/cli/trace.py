@@ -0,0 +1,59 @@
+"""Record a binary event trace from the keyboard over raw HID.
+"""
+import time
+
+from milc import cli
+
+from qmk.raw_text import RAW_USAGE_ID, RAW_USAGE_PAGE, open_device
+from qmk.trace import TraceReader, format_event, write_csv
+
+
+def _hex(value):
+    return int(value, 16)
+
+
+@cli.argument('-v', '--vid', type=_hex, help='Vendor ID of the keyboard, in hex.')
+@cli.argument('-p', '--pid', type=_hex, help='Product ID of the keyboard, in hex.')
+@cli.argument('--usage-page', type=_hex, default=RAW_USAGE_PAGE, help='Raw HID usage page, in hex.')
+@cli.argument('--usage', type=_hex, default=RAW_USAGE_ID, help='Raw HID usage, in hex.')
+@cli.argument('-d', '--duration', arg_only=True, type=float, help='Seconds to record for. Records until interrupted if not given.')
+@cli.argument('-o', '--output', arg_only=True, help='File to write the events to as CSV. Prints a timeline if not given.')
+@cli.subcommand('Record key event timing from a keyboard built with TRACE_ENABLE.')
+def trace(cli):
+    """Record the event trace and print it as a timeline or save it as CSV.
+    """
+    try:
+        device = open_device(cli.args.vid, cli.args.pid, cli.args.usage_page, cli.args.usage)
+    except ImportError:
+        cli.log.error('The {fg_cyan}hid{fg_reset} python module is required: python3 -m pip install hid')
+        return False
+
+    if not device:
+        cli.log.error('No raw HID device found.')
+        return False
+
+    reader = TraceReader(device)
+    events = []
+    end = time.monotonic() + cli.args.duration if cli.args.duration else None
+
+    cli.log.info('Recording, press Ctrl-C to stop.')
+
+    try:
+        while end is None or time.monotonic() < end:
+            for event in reader.poll():
+                if not cli.args.output:
+                    print(format_event(event, events[-1].time if events else None))
+                events.append(event)
+
+    except KeyboardInterrupt:
+        pass
+
+    reader.stop()
+
+    if reader.decoder.lost_packets:
+        cli.log.warning('%d packets were lost, the trace has gaps.', reader.decoder.lost_packets)
+
+    if cli.args.output:
+        with open(cli.args.output, 'w', newline='') as fd:
+            write_csv(events, fd)
+        cli.log.info('Wrote %d events to %s.', len(events), cli.args.output)
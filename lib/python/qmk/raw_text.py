@@ -0,0 +1,225 @@
+"""Host side of the raw HID text injection protocol.
+
+The keyboard sends UTF-8 text over raw HID and this module types it with the operating system's own input methods. See `quantum/raw_text.h` for the packet layout.
+"""
+import platform
+import shutil
+import subprocess
+import time
+
+RAW_TEXT_ID = 0xF5
+RAW_TEXT_VERSION = 2
+RAW_TEXT_HELLO = 0x01
+RAW_TEXT_DATA = 0x02
+RAW_TEXT_ACK = 0x03
+RAW_TEXT_END = 0x80
+RAW_TEXT_START = 0x40
+RAW_TEXT_LENGTH_MASK = 0x3F
+
+PACKET_SIZE = 32
+PAYLOAD_SIZE = PACKET_SIZE - 4
+
+RAW_USAGE_PAGE = 0xFF60
+RAW_USAGE_ID = 0x61
+
+
+def _packet(*data):
+    """Pad `data` to a full packet.
+    """
+    return bytes(data) + bytes(PACKET_SIZE - len(data))
+
+
+def hello_packet():
+    """Packet announcing the host to the keyboard.
+    """
+    return _packet(RAW_TEXT_ID, RAW_TEXT_HELLO, RAW_TEXT_VERSION)
+
+
+def ack_packet(seq):
+    """Packet acknowledging the text packet `seq`.
+    """
+    return _packet(RAW_TEXT_ID, RAW_TEXT_ACK, seq & 0xFF)
+
+
+def encode_text(text, seq=0, first=False):
+    """Split `text` into the packets the keyboard would send, starting at sequence number `seq`.
+
+    With `first`, the first packet is marked as the first one since the keyboard started.
+    """
+    data = text.encode('utf-8')
+    packets = []
+
+    while True:
+        chunk, data = data[:PAYLOAD_SIZE], data[PAYLOAD_SIZE:]
+        flags = RAW_TEXT_END if not data and len(chunk) < PAYLOAD_SIZE else 0
+        start = RAW_TEXT_START if first and not packets else 0
+        packets.append(_packet(RAW_TEXT_ID, RAW_TEXT_DATA, seq & 0xFF, start | flags | len(chunk), *chunk))
+        seq += 1
+
+        if flags:
+            return packets
+
+
+class TextReassembler:
+    """Collects text packets into strings.
+
+    Packets are acknowledged by the caller. The keyboard resends a packet whose acknowledgement got lost, so a repeated sequence number is acknowledged again but not used twice. The first packet since the keyboard started restarts the sequence.
+    """
+    def __init__(self):
+        self.pending = bytearray()
+        self.last_seq = None
+        self.last_packet = None
+
+    def feed(self, packet):
+        """Handle one text packet.
+
+        Returns a tuple of the acknowledgement to send back and the completed string, or None if the string isn't complete yet.
+        """
+        seq, length = packet[2], packet[3] & RAW_TEXT_LENGTH_MASK
+
+        # A resent first packet is the same packet again, anything else means the keyboard restarted
+        if packet[3] & RAW_TEXT_START and bytes(packet) != self.last_packet:
+            self.pending = bytearray()
+            self.last_seq = None
+
+        if seq == self.last_seq:
+            return ack_packet(seq), None
+
+        self.last_seq = seq
+        self.last_packet = bytes(packet)
+        self.pending += bytes(packet[4:4 + length])
+
+        if not packet[3] & RAW_TEXT_END:
+            return ack_packet(seq), None
+
+        text = self.pending.decode('utf-8', errors='replace')
+        self.pending = bytearray()
+
+        return ack_packet(seq), text
+
+
+class TextInjectionDaemon:
+    """Announce ourselves to the keyboard and type the text it sends.
+
+    `device` needs `write(packet)` and `read(size, timeout_ms)` methods returning bytes, `typer` is called with every received string.
+    """
+    def __init__(self, device, typer, hello_interval=1.0, clock=time.monotonic):
+        self.device = device
+        self.typer = typer
+        self.hello_interval = hello_interval
+        self.clock = clock
+        self.last_hello = None
+        self.reassembler = TextReassembler()
+
+    def poll(self, timeout_ms=100):
+        """Send HELLO when it is due and handle at most one packet from the keyboard.
+
+        Returns the string that was typed, if any.
+        """
+        now = self.clock()
+
+        if self.last_hello is None or now - self.last_hello >= self.hello_interval:
+            self.device.write(hello_packet())
+            self.last_hello = now
+
+        packet = self.device.read(PACKET_SIZE, timeout_ms)
+
+        if not packet or len(packet) < 4 or packet[0] != RAW_TEXT_ID or packet[1] != RAW_TEXT_DATA:
+            return None
+
+        ack, text = self.reassembler.feed(packet)
+        self.device.write(ack)
+
+        if text:
+            self.typer(text)
+
+        return text
+
+    def run(self):
+        """Poll the keyboard forever.
+        """
+        while True:
+            self.poll()
+
+
+class HidDevice:
+    """Thin wrapper around a `hid.device` from the hidapi bindings.
+    """
+    def __init__(self, device):
+        self.device = device
+
+    def write(self, packet):
+        # hidapi wants the report ID first, raw HID doesn't use one
+        self.device.write(b'\x00' + bytes(packet))
+
+    def read(self, size, timeout_ms):
+        return bytes(self.device.read(size, timeout_ms))
+
+
+def open_device(vid=None, pid=None, usage_page=RAW_USAGE_PAGE, usage=RAW_USAGE_ID):
+    """Open the first raw HID interface matching the arguments.
+    """
+    import hid
+
+    for info in hid.enumerate(vid or 0, pid or 0):
+        if info['usage_page'] == usage_page and info['usage'] == usage:
+            device = hid.device()
+            device.open_path(info['path'])
+            return HidDevice(device)
+
+    return None
+
+
+def type_text(text):
+    """Type `text` with the input method of the operating system we run on.
+    """
+    system = platform.system()
+
+    if system == 'Windows':
+        _type_text_windows(text)
+
+    elif system == 'Darwin':
+        escaped = text.replace('\\', '\\\\').replace('"', '\\"')
+        subprocess.run(['osascript', '-e', f'tell application "System Events" to keystroke "{escaped}"'], check=True)
+
+    elif shutil.which('wtype'):
+        subprocess.run(['wtype', '--', text], check=True)
+
+    else:
+        subprocess.run(['xdotool', 'type', '--', text], check=True)
+
+
+def _type_text_windows(text):
+    """Type `text` with SendInput() and KEYEVENTF_UNICODE, one UTF-16 code unit at a time.
+    """
+    import ctypes
+    from ctypes import wintypes
+
+    KEYEVENTF_KEYUP = 0x0002
+    KEYEVENTF_UNICODE = 0x0004
+    INPUT_KEYBOARD = 1
+
+    class KEYBDINPUT(ctypes.Structure):
+        _fields_ = [('wVk', wintypes.WORD), ('wScan', wintypes.WORD), ('dwFlags', wintypes.DWORD), ('time', wintypes.DWORD), ('dwExtraInfo', ctypes.POINTER(wintypes.ULONG))]
+
+    class INPUT(ctypes.Structure):
+        class _INPUT(ctypes.Union):
+            # MOUSEINPUT is the largest member, pad to its size
+            _fields_ = [('ki', KEYBDINPUT), ('padding', ctypes.c_ubyte * 32)]
+
+        _anonymous_ = ('u', )
+        _fields_ = [('type', wintypes.DWORD), ('u', _INPUT)]
+
+    data = text.encode('utf-16-le')
+    inputs = []
+
+    for i in range(0, len(data), 2):
+        unit = int.from_bytes(data[i:i + 2], 'little')
+
+        for flags in (KEYEVENTF_UNICODE, KEYEVENTF_UNICODE | KEYEVENTF_KEYUP):
+            event = INPUT(type=INPUT_KEYBOARD)
+            event.ki = KEYBDINPUT(wVk=0, wScan=unit, dwFlags=flags)
+            inputs.append(event)
+
+    array = (INPUT * len(inputs))(*inputs)
+    ctypes.windll.user32.SendInput(len(inputs), array, ctypes.sizeof(INPUT))
@@ -0,0 +1,117 @@
+from qmk.raw_text import PACKET_SIZE, RAW_TEXT_ACK, RAW_TEXT_HELLO, RAW_TEXT_ID, TextInjectionDaemon, encode_text
+
+
+class FakeDevice:
+    """Stands in for the keyboard's raw HID interface.
+    """
+    def __init__(self, packets=()):
+        self.incoming = list(packets)
+        self.written = []
+
+    def write(self, packet):
+        assert len(packet) == PACKET_SIZE
+        self.written.append(bytes(packet))
+
+    def read(self, size, timeout_ms):
+        return self.incoming.pop(0) if self.incoming else b''
+
+
+class FakeClock:
+    def __init__(self):
+        self.now = 0.0
+
+    def __call__(self):
+        return self.now
+
+
+def _daemon(packets):
+    typed = []
+    device = FakeDevice(packets)
+    clock = FakeClock()
+    return TextInjectionDaemon(device, typed.append, clock=clock), device, clock, typed
+
+
+def _acks(device):
+    return [p[2] for p in device.written if p[1] == RAW_TEXT_ACK]
+
+
+def test_hello_is_repeated():
+    daemon, device, clock, typed = _daemon([])
+    daemon.poll()
+    daemon.poll()
+    clock.now += 1.0
+    daemon.poll()
+    hellos = [p for p in device.written if p[0] == RAW_TEXT_ID and p[1] == RAW_TEXT_HELLO]
+    assert len(hellos) == 2
+
+
+def test_short_text():
+    daemon, device, clock, typed = _daemon(encode_text('hello'))
+    assert daemon.poll() == 'hello'
+    assert typed == ['hello']
+    assert _acks(device) == [0]
+
+
+def test_long_text_is_reassembled():
+    text = '😀 こんにちは世界 — ' * 4
+    packets = encode_text(text, seq=254)
+    assert len(packets) > 2
+    daemon, device, clock, typed = _daemon(packets)
+    for _ in packets:
+        daemon.poll()
+    assert typed == [text]
+    assert _acks(device) == [(254 + i) & 0xFF for i in range(len(packets))]
+
+
+def test_exact_payload_multiple():
+    text = 'x' * 28
+    packets = encode_text(text)
+    assert len(packets) == 2
+    daemon, device, clock, typed = _daemon(packets)
+    daemon.poll()
+    daemon.poll()
+    assert typed == [text]
+
+
+def test_resent_packet_is_typed_once():
+    packets = encode_text('abc')
+    daemon, device, clock, typed = _daemon(packets + packets)
+    daemon.poll()
+    daemon.poll()
+    assert typed == ['abc']
+    assert _acks(device) == [0, 0]
+
+
+def test_other_packets_are_ignored():
+    daemon, device, clock, typed = _daemon([bytes([0x01, 0x00, 0x09]) + bytes(PACKET_SIZE - 3)])
+    assert daemon.poll() is None
+    assert typed == []
+    assert _acks(device) == []
+
+
+def test_first_packet_after_keyboard_restart_is_typed():
+    before = encode_text('abc', first=True)
+    after = encode_text('def', first=True)
+    daemon, device, clock, typed = _daemon(before + after)
+    daemon.poll()
+    daemon.poll()
+    assert typed == ['abc', 'def']
+    assert _acks(device) == [0, 0]
+
+
+def test_resent_first_packet_is_typed_once():
+    packets = encode_text('abc', first=True)
+    daemon, device, clock, typed = _daemon(packets + packets + encode_text('def', seq=1))
+    daemon.poll()
+    daemon.poll()
+    daemon.poll()
+    assert typed == ['abc', 'def']
+    assert _acks(device) == [0, 0, 1]
+
+
+def test_restart_drops_a_partial_string():
+    partial = encode_text('x' * 40, first=True)[0]
+    daemon, device, clock, typed = _daemon([partial] + encode_text('abc', first=True))
+    daemon.poll()
+    daemon.poll()
+    assert typed == ['abc']
@@ -0,0 +1,85 @@
+import io
+
+from qmk.trace import PACKET_SIZE, TRACE_DATA, TRACE_DROPPED, TRACE_ID, TRACE_KEYCODE, TRACE_LAYER, TRACE_MATRIX, TRACE_REPORT, TRACE_START, TRACE_STOP, TraceDecoder, TraceReader, encode_packet, format_timeline, write_csv
+
+
+class FakeDevice:
+    """Stands in for the keyboard's raw HID interface.
+    """
+    def __init__(self, packets=()):
+        self.incoming = list(packets)
+        self.written = []
+
+    def write(self, packet):
+        assert len(packet) == PACKET_SIZE
+        self.written.append(bytes(packet))
+
+    def read(self, size, timeout_ms):
+        return self.incoming.pop(0) if self.incoming else b''
+
+
+class FakeClock:
+    def __init__(self):
+        self.now = 0.0
+
+    def __call__(self):
+        return self.now
+
+
+def test_start_is_repeated():
+    device = FakeDevice()
+    clock = FakeClock()
+    reader = TraceReader(device, clock=clock)
+    reader.poll()
+    reader.poll()
+    clock.now += 1.0
+    reader.poll()
+    reader.stop()
+    assert [p[:2] for p in device.written] == [bytes([TRACE_ID, TRACE_START])] * 2 + [bytes([TRACE_ID, TRACE_STOP])]
+
+
+def test_events_are_decoded():
+    packet = encode_packet(0, [(TRACE_MATRIX, 1, 0x0205, 1000), (TRACE_KEYCODE, 1, 0x0004, 1150), (TRACE_REPORT, 0x02, 1, 1400)])
+    reader = TraceReader(FakeDevice([packet]), clock=FakeClock())
+    events = reader.poll()
+    assert [(e.time, e.type, e.arg8, e.arg16) for e in events] == [(0, TRACE_MATRIX, 1, 0x0205), (150, TRACE_KEYCODE, 1, 0x0004), (400, TRACE_REPORT, 0x02, 1)]
+
+
+def test_time_wraps_around():
+    decoder = TraceDecoder()
+    events = decoder.feed(encode_packet(0, [(TRACE_MATRIX, 1, 0, 0xFFFFFF00)]))
+    events += decoder.feed(encode_packet(1, [(TRACE_MATRIX, 0, 0, 0x100)]))
+    assert [e.time for e in events] == [0, 0x200]
+
+
+def test_lost_packets_are_counted():
+    decoder = TraceDecoder()
+    for seq in (254, 255, 2, 3):
+        decoder.feed(encode_packet(seq, [(TRACE_LAYER, 1, 2, seq)]))
+    assert decoder.lost_packets == 2
+
+
+def test_other_packets_are_ignored():
+    decoder = TraceDecoder()
+    assert decoder.feed(bytes([0x01, TRACE_DATA, 0x09]) + bytes(PACKET_SIZE - 3)) == []
+    assert decoder.feed(b'') == []
+
+
+def test_timeline():
+    decoder = TraceDecoder()
+    events = decoder.feed(encode_packet(0, [(TRACE_MATRIX, 1, 0x0103, 500), (TRACE_DROPPED, 0, 7, 2500)]))
+    lines = list(format_timeline(events))
+    assert lines[0].split() == ['0.000', 'ms', '+0.000', 'matrix', 'row', '1', 'col', '3', 'down']
+    assert lines[1].split() == ['2.000', 'ms', '+2.000', 'dropped', '7', 'events', 'lost', 'on', 'the', 'keyboard']
+
+
+def test_csv():
+    decoder = TraceDecoder()
+    events = decoder.feed(encode_packet(0, [(TRACE_KEYCODE, 0, 0x0029, 10), (TRACE_LAYER, 1, 0x0003, 30)]))
+    fd = io.StringIO()
+    write_csv(events, fd)
+    assert fd.getvalue().splitlines() == [
+        'time_us,event,arg8,arg16,description',
+        '0,keycode,0,41,0x0029 up',
+        '20,layer,1,3,"layer 1, state 0x0003"',
+    ]
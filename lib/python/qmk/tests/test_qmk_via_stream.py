@@ -0,0 +1,125 @@
+import ctypes
+import random
+import shutil
+import subprocess
+from pathlib import Path
+
+import pytest
+
+from qmk.via_stream import PACKET_SIZE, VIA_STREAM_CUSTOM_CONFIG, VIA_STREAM_KEYMAP, VIA_STREAM_LIGHTING, VIA_STREAM_MACROS, ViaStreamClient, ViaStreamError
+
+QMK_FIRMWARE = Path(__file__).resolve().parents[4]
+LOOPBACK = Path(__file__).resolve().parent / 'via_stream_loopback'
+CUSTOM_CONFIG_SIZE = 32
+
+
+@pytest.fixture(scope='module')
+def keyboard(tmp_path_factory):
+    """quantum/via_stream.c built for the host, see via_stream_loopback/loopback.c.
+    """
+    compiler = shutil.which('cc') or shutil.which('gcc')
+    if not compiler:
+        pytest.skip('no C compiler')
+
+    build = tmp_path_factory.mktemp('via_stream')
+    # A copy, so the stub quantum.h is picked up instead of the real one next to it
+    shutil.copy(QMK_FIRMWARE / 'quantum/via_stream.c', build)
+    library = build / 'via_stream.so'
+    subprocess.run([
+        compiler, '-shared', '-fPIC', '-w', '-DVIA_EEPROM_CUSTOM_CONFIG_SIZE=%d' % CUSTOM_CONFIG_SIZE, '-I', str(LOOPBACK), '-I', str(QMK_FIRMWARE), '-I', str(QMK_FIRMWARE / 'quantum'), '-I', str(QMK_FIRMWARE / 'tmk_core/common'), '-o', str(library), str(build / 'via_stream.c'), str(LOOPBACK / 'loopback.c')
+    ], check=True)
+
+    lib = ctypes.CDLL(str(library))
+    lib.via_stream_receive.restype = ctypes.c_bool
+    lib.loopback_pop.restype = ctypes.c_bool
+    return lib
+
+
+class LoopbackDevice:
+    """Talks to the keyboard side, losing a share of the packets both ways.
+    """
+    def __init__(self, lib, loss=0.0, seed=0):
+        self.lib = lib
+        self.loss = loss
+        self.random = random.Random(seed)
+        self.elapsed_ms = 0
+
+    def write(self, packet):
+        assert len(packet) == PACKET_SIZE
+        if self.random.random() >= self.loss:
+            assert self.lib.via_stream_receive(ctypes.create_string_buffer(bytes(packet), PACKET_SIZE), PACKET_SIZE)
+
+    def read(self, size, timeout_ms):
+        packet = ctypes.create_string_buffer(PACKET_SIZE)
+        for _ in range(timeout_ms):
+            while self.lib.loopback_pop(packet):
+                if self.random.random() >= self.loss:
+                    return packet.raw
+
+            self.lib.loopback_tick()
+            self.elapsed_ms += 1
+
+        return b''
+
+
+def _region(keyboard, name, size):
+    return (ctypes.c_uint8 * size).in_dll(keyboard, name)
+
+
+def _random_bytes(size, seed):
+    return bytes(random.Random(seed).randrange(256) for _ in range(size))
+
+
+def test_read_keymap(keyboard):
+    keymap = _random_bytes(600, 1)
+    ctypes.memmove(_region(keyboard, 'keymap', 600), keymap, 600)
+    device = LoopbackDevice(keyboard)
+    assert ViaStreamClient(device).read(VIA_STREAM_KEYMAP, 0, 600) == keymap
+    # One packet per ms, instead of one per round trip
+    assert device.elapsed_ms < 40
+
+
+def test_write_macros(keyboard):
+    macros = _random_bytes(100, 2)
+    client = ViaStreamClient(LoopbackDevice(keyboard))
+    client.write(VIA_STREAM_MACROS, 0, macros)
+    assert bytes(_region(keyboard, 'macros', 100)) == macros
+    assert client.read(VIA_STREAM_MACROS, 10, 50) == macros[10:60]
+
+
+def test_write_custom_config(keyboard):
+    client = ViaStreamClient(LoopbackDevice(keyboard))
+    client.write(VIA_STREAM_CUSTOM_CONFIG, 4, b'\x01\x02\x03')
+    assert client.read(VIA_STREAM_CUSTOM_CONFIG, 4, 3) == b'\x01\x02\x03'
+
+
+def test_write_lighting(keyboard):
+    client = ViaStreamClient(LoopbackDevice(keyboard))
+    lighting = bytes(range(1, 11))
+    client.write(VIA_STREAM_LIGHTING, 0, lighting)
+    assert client.read(VIA_STREAM_LIGHTING, 0, 10) == lighting
+    # Backlight, rgblight and rgb_matrix where eeconfig keeps them
+    eeprom = bytes(_region(keyboard, 'eeprom', 256))
+    assert eeprom[6:7] + eeprom[8:12] + eeprom[28:33] == lighting
+    with pytest.raises(ViaStreamError, match='range'):
+        client.read(VIA_STREAM_LIGHTING, 0, 11)
+
+
+def test_bad_requests(keyboard):
+    client = ViaStreamClient(LoopbackDevice(keyboard))
+    with pytest.raises(ViaStreamError, match='range'):
+        client.read(VIA_STREAM_MACROS, 90, 20)
+    with pytest.raises(ViaStreamError, match='range'):
+        client.read(VIA_STREAM_CUSTOM_CONFIG, 0, CUSTOM_CONFIG_SIZE + 1)
+    with pytest.raises(ViaStreamError, match='region'):
+        client.read(0x7F, 0, 1)
+
+
+@pytest.mark.parametrize('seed', range(5))
+def test_lossy_round_trip(keyboard, seed):
+    keymap = _random_bytes(600, seed)
+    client = ViaStreamClient(LoopbackDevice(keyboard, loss=0.1, seed=seed))
+    client.write(VIA_STREAM_KEYMAP, 0, keymap)
+    assert bytes(_region(keyboard, 'keymap', 600)) == keymap
+    ctypes.memmove(_region(keyboard, 'keymap', 600), keymap[::-1], 600)
+    assert client.read(VIA_STREAM_KEYMAP, 0, 600) == keymap[::-1]
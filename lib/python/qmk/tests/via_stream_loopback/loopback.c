@@ -0,0 +1,61 @@
+/* Runs quantum/via_stream.c on the host, with the keyboard side of raw HID,
+ * the timer, the dynamic keymap and the EEPROM kept in memory.
+ */
+#include <string.h>
+
+#include "quantum.h"
+#include "raw_hid.h"
+#include "dynamic_keymap.h"
+#include "via_stream.h"
+
+#define KEYMAP_SIZE 600
+#define MACROS_SIZE 100
+#define PACKETS 64
+
+uint8_t keymap[KEYMAP_SIZE];
+uint8_t macros[MACROS_SIZE];
+uint8_t eeprom[256];
+
+static uint16_t now;
+static uint8_t  sent[PACKETS][32];
+static uint8_t  sent_head;
+static uint8_t  sent_count;
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    // Like LUFA, a packet the host hasn't picked up yet is lost
+    if (sent_count < PACKETS) {
+        memcpy(sent[(sent_head + sent_count++) % PACKETS], data, length);
+    }
+}
+
+uint16_t timer_read(void) { return now; }
+uint16_t timer_elapsed(uint16_t last) { return now - last; }
+
+uint16_t dynamic_keymap_get_buffer_size(void) { return KEYMAP_SIZE; }
+void     dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) { memcpy(data, &keymap[offset], size); }
+void     dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) { memcpy(&keymap[offset], data, size); }
+uint16_t dynamic_keymap_macro_get_buffer_size(void) { return MACROS_SIZE; }
+void     dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) { memcpy(data, &macros[offset], size); }
+void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) { memcpy(&macros[offset], data, size); }
+
+uint8_t eeprom_read_byte(const uint8_t *addr) { return eeprom[(uintptr_t)addr]; }
+void    eeprom_update_byte(uint8_t *addr, uint8_t value) { eeprom[(uintptr_t)addr] = value; }
+void    eeprom_read_block(void *dst, const void *src, size_t n) { memcpy(dst, &eeprom[(uintptr_t)src], n); }
+void    eeprom_update_block(const void *src, void *dst, size_t n) { memcpy(&eeprom[(uintptr_t)dst], src, n); }
+
+/* one millisecond of the main loop */
+void loopback_tick(void) {
+    now++;
+    via_stream_task();
+}
+
+/* the oldest packet sent to the host, false when there is none */
+bool loopback_pop(uint8_t *data) {
+    if (!sent_count) {
+        return false;
+    }
+    memcpy(data, sent[sent_head], 32);
+    sent_head = (sent_head + 1) % PACKETS;
+    sent_count--;
+    return true;
+}
@@ -0,0 +1,7 @@
+/* Just enough of quantum.h to build quantum/via_stream.c on the host. */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct keyrecord_t keyrecord_t;
@@ -0,0 +1,179 @@
+"""Host side of the binary event trace.
+
+The keyboard streams timestamped key events over raw HID while this module keeps asking for them, and decodes them into a timeline. See `quantum/trace.h` for the packet layout.
+"""
+import csv
+import time
+from collections import namedtuple
+
+TRACE_ID = 0xF6
+TRACE_VERSION = 1
+TRACE_START = 0x01
+TRACE_DATA = 0x02
+TRACE_STOP = 0x03
+
+TRACE_MATRIX = 0x01
+TRACE_KEYCODE = 0x02
+TRACE_REPORT = 0x03
+TRACE_LAYER = 0x04
+TRACE_DROPPED = 0x05
+
+EVENT_NAMES = {
+    TRACE_MATRIX: 'matrix',
+    TRACE_KEYCODE: 'keycode',
+    TRACE_REPORT: 'report',
+    TRACE_LAYER: 'layer',
+    TRACE_DROPPED: 'dropped',
+}
+
+PACKET_SIZE = 32
+EVENT_SIZE = 8
+EVENTS_PER_PACKET = (PACKET_SIZE - 4) // EVENT_SIZE
+
+TraceEvent = namedtuple('TraceEvent', 'time type arg8 arg16')
+TraceEvent.__doc__ = 'An event with its time in microseconds since the first event of the trace.'
+
+
+def _packet(*data):
+    """Pad `data` to a full packet.
+    """
+    return bytes(data) + bytes(PACKET_SIZE - len(data))
+
+
+def start_packet():
+    """Packet asking the keyboard to trace, repeated while we listen.
+    """
+    return _packet(TRACE_ID, TRACE_START, TRACE_VERSION)
+
+
+def stop_packet():
+    """Packet telling the keyboard to stop tracing right away.
+    """
+    return _packet(TRACE_ID, TRACE_STOP)
+
+
+def encode_packet(seq, events):
+    """Build the packet the keyboard would send for `events`, a list of (type, arg8, arg16, time) tuples.
+    """
+    data = [TRACE_ID, TRACE_DATA, seq & 0xFF, len(events)]
+
+    for event_type, arg8, arg16, event_time in events:
+        data += [event_type, arg8, *arg16.to_bytes(2, 'little'), *(event_time & 0xFFFFFFFF).to_bytes(4, 'little')]
+
+    return _packet(*data)
+
+
+class TraceDecoder:
+    """Turns trace packets into events.
+
+    The keyboard's microsecond clock wraps every 71 minutes, times are unwrapped and made relative to the first event. Packets aren't resent by the keyboard, `lost_packets` counts the gaps in their sequence numbers.
+    """
+    def __init__(self):
+        self.last_seq = None
+        self.last_time = None
+        self.time = 0
+        self.lost_packets = 0
+
+    def feed(self, packet):
+        """Decode one packet, returns the list of events in it.
+        """
+        if not packet or len(packet) < 4 or packet[0] != TRACE_ID or packet[1] != TRACE_DATA:
+            return []
+
+        seq = packet[2]
+        if self.last_seq is not None:
+            self.lost_packets += (seq - self.last_seq - 1) & 0xFF
+        self.last_seq = seq
+
+        events = []
+        for i in range(min(packet[3], EVENTS_PER_PACKET)):
+            data = packet[4 + i * EVENT_SIZE:4 + (i + 1) * EVENT_SIZE]
+            raw_time = int.from_bytes(data[4:8], 'little')
+
+            if self.last_time is not None:
+                self.time += (raw_time - self.last_time) & 0xFFFFFFFF
+            self.last_time = raw_time
+
+            events.append(TraceEvent(self.time, data[0], data[1], int.from_bytes(data[2:4], 'little')))
+
+        return events
+
+
+def describe(event):
+    """Human readable description of an event.
+    """
+    if event.type == TRACE_MATRIX:
+        return 'row %d col %d %s' % (event.arg16 >> 8, event.arg16 & 0xFF, 'down' if event.arg8 else 'up')
+
+    if event.type == TRACE_KEYCODE:
+        return '0x%04X %s' % (event.arg16, 'down' if event.arg8 else 'up')
+
+    if event.type == TRACE_REPORT:
+        return 'mods 0x%02X, %d keys' % (event.arg8, event.arg16)
+
+    if event.type == TRACE_LAYER:
+        return 'layer %d, state 0x%04X' % (event.arg8, event.arg16)
+
+    if event.type == TRACE_DROPPED:
+        return '%d events lost on the keyboard' % event.arg16
+
+    return 'arg8 0x%02X, arg16 0x%04X' % (event.arg8, event.arg16)
+
+
+def format_event(event, previous_time=None):
+    """One timeline line for `event`, with its time and the time since `previous_time` in milliseconds.
+    """
+    delta = event.time - previous_time if previous_time is not None else 0
+
+    return '%12.3f ms  %+9.3f  %-8s %s' % (event.time / 1000, delta / 1000, EVENT_NAMES.get(event.type, 'unknown'), describe(event))
+
+
+def format_timeline(events):
+    """Yield a timeline line for each event.
+    """
+    previous_time = None
+
+    for event in events:
+        yield format_event(event, previous_time)
+        previous_time = event.time
+
+
+def write_csv(events, fd):
+    """Write `events` to the file object `fd` as CSV, times in microseconds.
+    """
+    writer = csv.writer(fd)
+    writer.writerow(['time_us', 'event', 'arg8', 'arg16', 'description'])
+
+    for event in events:
+        writer.writerow([event.time, EVENT_NAMES.get(event.type, event.type), event.arg8, event.arg16, describe(event)])
+
+
+class TraceReader:
+    """Keep the keyboard tracing and decode what it sends.
+
+    `device` needs `write(packet)` and `read(size, timeout_ms)` methods returning bytes, like `qmk.raw_text.HidDevice`.
+    """
+    def __init__(self, device, start_interval=1.0, clock=time.monotonic):
+        self.device = device
+        self.start_interval = start_interval
+        self.clock = clock
+        self.last_start = None
+        self.decoder = TraceDecoder()
+
+    def poll(self, timeout_ms=100):
+        """Send START when it is due and decode at most one packet from the keyboard.
+
+        Returns the list of events received.
+        """
+        now = self.clock()
+
+        if self.last_start is None or now - self.last_start >= self.start_interval:
+            self.device.write(start_packet())
+            self.last_start = now
+
+        return self.decoder.feed(self.device.read(PACKET_SIZE, timeout_ms))
+
+    def stop(self):
+        """Tell the keyboard to stop tracing.
+        """
+        self.device.write(stop_packet())
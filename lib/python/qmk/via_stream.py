@@ -0,0 +1,184 @@
+"""Host side of the streamed VIA bulk transfers.
+
+Reads and writes whole regions of the keyboard's dynamic keymap, macro buffer, custom config EEPROM or lighting settings with a window of packets in flight, instead of one request per 28 bytes. See `quantum/via_stream.h` for the protocol.
+"""
+VIA_ID_STREAM = 0x80
+
+VIA_STREAM_OPEN = 0x01
+VIA_STREAM_DATA = 0x02
+VIA_STREAM_ACK = 0x03
+VIA_STREAM_CLOSE = 0x04
+
+VIA_STREAM_WRITE = 0x01
+
+VIA_STREAM_KEYMAP = 0x01
+VIA_STREAM_MACROS = 0x02
+VIA_STREAM_CUSTOM_CONFIG = 0x03
+VIA_STREAM_LIGHTING = 0x04
+
+VIA_STREAM_OK = 0x00
+VIA_STREAM_DONE = 0x01
+VIA_STREAM_BAD_REGION = 0x02
+VIA_STREAM_BAD_RANGE = 0x03
+VIA_STREAM_NOT_OPEN = 0x04
+
+STATUS_NAMES = {
+    VIA_STREAM_BAD_REGION: 'unknown region',
+    VIA_STREAM_BAD_RANGE: 'offset or length out of range',
+    VIA_STREAM_NOT_OPEN: 'no transfer open',
+}
+
+PACKET_SIZE = 32
+PAYLOAD_SIZE = PACKET_SIZE - 4
+
+
+class ViaStreamError(Exception):
+    """The keyboard refused a transfer or stopped answering.
+    """
+
+
+def _packet(*data):
+    """Pad `data` to a full packet.
+    """
+    data = bytes(data)
+    return data + bytes(PACKET_SIZE - len(data))
+
+
+def open_packet(region, offset, length, window, write=False):
+    return _packet(VIA_ID_STREAM, VIA_STREAM_OPEN, region, VIA_STREAM_WRITE if write else 0, offset >> 8, offset & 0xFF, length >> 8, length & 0xFF, window)
+
+
+def data_packet(seq, payload):
+    return _packet(VIA_ID_STREAM, VIA_STREAM_DATA, seq & 0xFF, len(payload), *payload)
+
+
+def ack_packet(seq):
+    return _packet(VIA_ID_STREAM, VIA_STREAM_ACK, seq & 0xFF, VIA_STREAM_OK)
+
+
+def close_packet():
+    return _packet(VIA_ID_STREAM, VIA_STREAM_CLOSE)
+
+
+class ViaStreamClient:
+    """Streams regions to and from the keyboard.
+
+    `device` needs `write(packet)` and `read(size, timeout_ms)` methods returning bytes, like `qmk.raw_text.HidDevice`. A read that times out makes the client send again from the first packet not acknowledged, and `retries` timeouts in a row fail the transfer.
+    """
+    def __init__(self, device, window=8, timeout_ms=50, retries=20):
+        self.device = device
+        self.window = window
+        self.timeout_ms = timeout_ms
+        self.retries = retries
+
+    def _receive(self, command):
+        """Wait for a stream packet with `command`, None on timeout.
+        """
+        while True:
+            packet = self.device.read(PACKET_SIZE, self.timeout_ms)
+
+            if not packet:
+                return None
+
+            if packet[0] == VIA_ID_STREAM and packet[1] == command:
+                return packet
+
+    def _open(self, region, offset, length, write):
+        for _ in range(self.retries):
+            self.device.write(open_packet(region, offset, length, self.window, write))
+            reply = self._receive(VIA_STREAM_OPEN)
+
+            if reply:
+                if reply[2] != VIA_STREAM_OK:
+                    raise ViaStreamError(STATUS_NAMES.get(reply[2], 'status %d' % reply[2]))
+
+                return reply[3]
+
+        raise ViaStreamError('no reply to open')
+
+    def _close(self):
+        for _ in range(self.retries):
+            self.device.write(close_packet())
+
+            if self._receive(VIA_STREAM_CLOSE):
+                return
+
+    def read(self, region, offset, length):
+        """Read `length` bytes at `offset` in `region`.
+        """
+        self._open(region, offset, length, write=False)
+        packets = (length + PAYLOAD_SIZE - 1) // PAYLOAD_SIZE
+        data = bytearray()
+        received = 0
+        gap_reported = False
+        timeouts = 0
+
+        while received < packets:
+            packet = self.device.read(PACKET_SIZE, self.timeout_ms)
+
+            if not packet:
+                # Tell the keyboard where we are, which also makes it go back
+                timeouts += 1
+                if timeouts > self.retries:
+                    raise ViaStreamError('keyboard stopped sending')
+
+                self.device.write(ack_packet(received - 1))
+                continue
+
+            if packet[0] != VIA_ID_STREAM or packet[1] != VIA_STREAM_DATA:
+                continue
+
+            timeouts = 0
+            if packet[2] != received & 0xFF:
+                if not gap_reported:
+                    self.device.write(ack_packet(received - 1))
+                    gap_reported = True
+                continue
+
+            data += packet[4:4 + packet[3]]
+            received += 1
+            gap_reported = False
+            self.device.write(ack_packet(received - 1))
+
+        self._close()
+        return bytes(data[:length])
+
+    def write(self, region, offset, data):
+        """Write `data` at `offset` in `region`.
+        """
+        window = self._open(region, offset, len(data), write=True)
+        packets = (len(data) + PAYLOAD_SIZE - 1) // PAYLOAD_SIZE
+        acked = 0
+        sent = 0
+        timeouts = 0
+
+        while True:
+            while sent < packets and sent - acked < window:
+                self.device.write(data_packet(sent, data[sent * PAYLOAD_SIZE:(sent + 1) * PAYLOAD_SIZE]))
+                sent += 1
+
+            ack = self._receive(VIA_STREAM_ACK)
+
+            if not ack:
+                timeouts += 1
+                if timeouts > self.retries:
+                    raise ViaStreamError('keyboard stopped acknowledging')
+
+                sent = acked
+                continue
+
+            if ack[3] == VIA_STREAM_NOT_OPEN:
+                raise ViaStreamError(STATUS_NAMES[VIA_STREAM_NOT_OPEN])
+
+            timeouts = 0
+            newly_acked = ((ack[2] - acked) & 0xFF) + 1
+            if newly_acked <= sent - acked:
+                acked += newly_acked
+            else:
+                # The keyboard saw a gap
+                sent = acked
+
+            if ack[3] == VIA_STREAM_DONE and acked == packets:
+                break
+
+        self._close()
@@ -206,6 +206,10 @@ static void print_status(void) {
     print_val_hex8(keymap_config.nkro);
 #endif
     print_val_hex32(timer_read32());
+#ifndef NO_ACTION_TAPPING
+    print_val_dec(action_tapping_get_overflow_count());
+    print_val_dec(action_tapping_get_buffer_peak());
+#endif
     return;
 }
 
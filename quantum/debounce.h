@@ -9,3 +9,8 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 bool debounce_active(void);
 
 void debounce_init(uint8_t num_rows);
+
+#ifdef DEBOUNCE_PER_KEY
+// debounce time in ms for the key at row, col; only used by algorithms that support it
+uint8_t get_debounce_time(uint8_t row, uint8_t col);
+#endif
@@ -0,0 +1,129 @@
+/*
+Copyright 2021 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Asymmetric per-key algorithm. Eager on key-down, defer on key-up.
+A press is pushed immediately, after which the key ignores input for DEBOUNCE milliseconds.
+A release is only pushed once the key has stayed released for DEBOUNCE milliseconds.
+With DEBOUNCE_PER_KEY defined, get_debounce_time() sets the time for each key.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+#include "debounce.h"
+#include <string.h>
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 127ms
+#if DEBOUNCE > 127
+#    undef DEBOUNCE
+#    define DEBOUNCE 127
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+typedef struct {
+    bool    pressed : 1;  // counting down the lock after a press, not a pending release
+    uint8_t time : 7;     // ms left, 0 when idle
+} debounce_counter_t;
+
+#if DEBOUNCE > 0
+static debounce_counter_t debounce_counters[MATRIX_ROWS * MATRIX_COLS];
+static uint16_t           last_time;
+static bool               counters_need_update;
+
+#    ifdef DEBOUNCE_PER_KEY
+__attribute__((weak)) uint8_t get_debounce_time(uint8_t row, uint8_t col) { return DEBOUNCE; }
+
+static uint8_t debounce_time(uint8_t row, uint8_t col) {
+    uint8_t time = get_debounce_time(row, col);
+    return time > 127 ? 127 : time;
+}
+#    else
+#        define debounce_time(row, col) DEBOUNCE
+#    endif
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    memset(debounce_counters, 0, sizeof(debounce_counters));
+    last_time            = timer_read();
+    counters_need_update = false;
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+    last_time        = now;
+
+    if (!changed && !counters_need_update) {
+        return;
+    }
+
+    counters_need_update                 = false;
+    debounce_counter_t *debounce_pointer = debounce_counters;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        for (uint8_t col = 0; col < MATRIX_COLS; col++, debounce_pointer++) {
+            matrix_row_t col_mask = ROW_SHIFTER << col;
+
+            if (debounce_pointer->time) {
+                if (!debounce_pointer->pressed && !(delta & col_mask)) {
+                    // Bounced back down before the release was pushed
+                    debounce_pointer->time = 0;
+                    continue;
+                }
+                if (debounce_pointer->time > elapsed) {
+                    debounce_pointer->time -= elapsed;
+                    counters_need_update = true;
+                    continue;
+                }
+                debounce_pointer->time = 0;
+                if (!debounce_pointer->pressed) {
+                    // Stayed released for the whole debounce time
+                    cooked[row] &= ~col_mask;
+                    continue;
+                }
+            }
+
+            if (delta & col_mask) {
+                uint8_t time = debounce_time(row, col);
+                if (raw[row] & col_mask) {
+                    cooked[row] |= col_mask;
+                } else if (!time) {
+                    cooked[row] &= ~col_mask;
+                }
+                debounce_pointer->pressed = raw[row] & col_mask;
+                debounce_pointer->time    = time;
+                counters_need_update |= time != 0;
+            }
+        }
+    }
+}
+
+bool debounce_active(void) { return counters_need_update; }
+#else
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    if (changed) {
+        memcpy(cooked, raw, num_rows * sizeof(matrix_row_t));
+    }
+}
+
+bool debounce_active(void) { return false; }
+#endif
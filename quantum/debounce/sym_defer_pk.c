@@ -22,6 +22,7 @@ When no state changes have occured for DEBOUNCE milliseconds, we push the state.
 #include "timer.h"
 #include "quantum.h"
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef PROTOCOL_CHIBIOS
 #    if CH_CFG_USE_MEMCORE == FALSE
@@ -39,6 +40,11 @@ When no state changes have occured for DEBOUNCE milliseconds, we push the state.
 
 static debounce_counter_t *debounce_counters;
 static bool                counters_need_update;
+static uint8_t             rows_pending[(MATRIX_ROWS + 7) / 8];  // rows with running counters
+
+#define ROW_PENDING(row) (rows_pending[(row) / 8] & (1 << ((row) % 8)))
+#define SET_ROW_PENDING(row) (rows_pending[(row) / 8] |= (1 << ((row) % 8)))
+#define CLEAR_ROW_PENDING(row) (rows_pending[(row) / 8] &= ~(1 << ((row) % 8)))
 
 #define DEBOUNCE_ELAPSED 251
 #define MAX_DEBOUNCE (DEBOUNCE_ELAPSED - 1)
@@ -65,6 +71,8 @@ void debounce_init(uint8_t num_rows) {
             debounce_counters[i++] = DEBOUNCE_ELAPSED;
         }
     }
+    memset(rows_pending, 0, sizeof(rows_pending));
+    counters_need_update = false;
 }
 
 void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
@@ -81,37 +89,55 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t current_time) {
     counters_need_update                 = false;
     debounce_counter_t *debounce_pointer = debounce_counters;
-    for (uint8_t row = 0; row < num_rows; row++) {
+    for (uint8_t row = 0; row < num_rows; row++, debounce_pointer += MATRIX_COLS) {
+        if (!ROW_PENDING(row)) {
+            continue;
+        }
+        bool row_pending = false;
         for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            if (*debounce_pointer != DEBOUNCE_ELAPSED) {
-                if (TIMER_DIFF(current_time, *debounce_pointer, MAX_DEBOUNCE) >= DEBOUNCE) {
-                    *debounce_pointer = DEBOUNCE_ELAPSED;
-                    cooked[row]       = (cooked[row] & ~(ROW_SHIFTER << col)) | (raw[row] & (ROW_SHIFTER << col));
+            if (debounce_pointer[col] != DEBOUNCE_ELAPSED) {
+                if (TIMER_DIFF(current_time, debounce_pointer[col], MAX_DEBOUNCE) >= DEBOUNCE) {
+                    debounce_pointer[col] = DEBOUNCE_ELAPSED;
+                    cooked[row]           = (cooked[row] & ~(ROW_SHIFTER << col)) | (raw[row] & (ROW_SHIFTER << col));
                 } else {
-                    counters_need_update = true;
+                    row_pending = true;
                 }
             }
-            debounce_pointer++;
+        }
+        if (row_pending) {
+            counters_need_update = true;
+        } else {
+            CLEAR_ROW_PENDING(row);
         }
     }
 }
 
 void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t current_time) {
     debounce_counter_t *debounce_pointer = debounce_counters;
-    for (uint8_t row = 0; row < num_rows; row++) {
+    for (uint8_t row = 0; row < num_rows; row++, debounce_pointer += MATRIX_COLS) {
         matrix_row_t delta = raw[row] ^ cooked[row];
+        // Rows without running counters or changes have nothing to reset
+        if (!delta && !ROW_PENDING(row)) {
+            continue;
+        }
+        bool row_pending = false;
         for (uint8_t col = 0; col < MATRIX_COLS; col++) {
             if (delta & (ROW_SHIFTER << col)) {
-                if (*debounce_pointer == DEBOUNCE_ELAPSED) {
-                    *debounce_pointer    = current_time;
-                    counters_need_update = true;
+                if (debounce_pointer[col] == DEBOUNCE_ELAPSED) {
+                    debounce_pointer[col] = current_time;
                 }
+                row_pending = true;
             } else {
-                *debounce_pointer = DEBOUNCE_ELAPSED;
+                debounce_pointer[col] = DEBOUNCE_ELAPSED;
             }
-            debounce_pointer++;
+        }
+        if (row_pending) {
+            SET_ROW_PENDING(row);
+            counters_need_update = true;
+        } else {
+            CLEAR_ROW_PENDING(row);
         }
     }
 }
 
-bool debounce_active(void) { return true; }
+bool debounce_active(void) { return counters_need_update; }
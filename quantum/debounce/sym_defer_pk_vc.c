@@ -0,0 +1,135 @@
+/*
+Copyright 2021 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Symmetric per-key algorithm using vertical counters. Behaves like sym_defer_pk:
+when no state changes have occured for DEBOUNCE milliseconds on a key, its state is pushed.
+
+Instead of a counter per key, bit n of every key's counter is kept in one matrix_row_t
+per row, so a whole row of counters is cleared, incremented and compared with a handful
+of word operations, no matter how many columns there are. Nothing is allocated at runtime.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+#include <string.h>
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+#if DEBOUNCE > 250
+#    error "DEBOUNCE can't be greater than 250 with sym_defer_pk_vc"
+#endif
+
+// A counter starts at 1 when a change is seen and the change is pushed when it reaches DEBOUNCE_DONE
+#define DEBOUNCE_DONE (DEBOUNCE + 1)
+
+#if DEBOUNCE_DONE < 2
+#    define COUNTER_BITS 1
+#elif DEBOUNCE_DONE < 4
+#    define COUNTER_BITS 2
+#elif DEBOUNCE_DONE < 8
+#    define COUNTER_BITS 3
+#elif DEBOUNCE_DONE < 16
+#    define COUNTER_BITS 4
+#elif DEBOUNCE_DONE < 32
+#    define COUNTER_BITS 5
+#elif DEBOUNCE_DONE < 64
+#    define COUNTER_BITS 6
+#elif DEBOUNCE_DONE < 128
+#    define COUNTER_BITS 7
+#else
+#    define COUNTER_BITS 8
+#endif
+
+static matrix_row_t counters[MATRIX_ROWS][COUNTER_BITS];
+static uint16_t     last_time;
+static bool         counters_need_update;
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    memset(counters, 0, sizeof(counters));
+    last_time            = timer_read();
+    counters_need_update = false;
+}
+
+#if DEBOUNCE > 0
+static bool debounce_row(matrix_row_t counter[], matrix_row_t raw, matrix_row_t *cooked, uint16_t elapsed) {
+    matrix_row_t delta = raw ^ *cooked;
+
+    // Keys back in their debounced state start over
+    matrix_row_t counting = 0;
+    for (uint8_t i = 0; i < COUNTER_BITS; i++) {
+        counter[i] &= delta;
+        counting |= counter[i];
+    }
+
+    for (; elapsed && counting; elapsed--) {
+        // Add one to every running counter, rippling the carry up through the bits
+        matrix_row_t carry = counting;
+        for (uint8_t i = 0; i < COUNTER_BITS; i++) {
+            matrix_row_t next = counter[i] & carry;
+            counter[i] ^= carry;
+            carry = next;
+        }
+
+        // Push the keys whose counter reached DEBOUNCE_DONE
+        matrix_row_t done = counting;
+        for (uint8_t i = 0; i < COUNTER_BITS; i++) {
+            done &= (DEBOUNCE_DONE >> i) & 1 ? counter[i] : ~counter[i];
+        }
+        if (done) {
+            *cooked ^= done;
+            counting &= ~done;
+            for (uint8_t i = 0; i < COUNTER_BITS; i++) {
+                counter[i] &= ~done;
+            }
+        }
+    }
+
+    // Start counting newly changed keys
+    matrix_row_t pending = raw ^ *cooked;
+    counter[0] |= pending & ~counting;
+    return pending != 0;
+}
+#endif
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+#if DEBOUNCE == 0
+    if (changed) {
+        memcpy(cooked, raw, num_rows * sizeof(matrix_row_t));
+    }
+#else
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+    last_time        = now;
+
+    if (!changed && !counters_need_update) {
+        return;
+    }
+
+    if (elapsed > DEBOUNCE) {
+        elapsed = DEBOUNCE;
+    }
+
+    counters_need_update = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        counters_need_update |= debounce_row(counters[row], raw[row], &cooked[row], elapsed);
+    }
+#endif
+}
+
+bool debounce_active(void) { return counters_need_update; }
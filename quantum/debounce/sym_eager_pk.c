@@ -22,6 +22,7 @@ No further inputs are accepted until DEBOUNCE milliseconds have occurred.
 #include "timer.h"
 #include "quantum.h"
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef PROTOCOL_CHIBIOS
 #    if CH_CFG_USE_MEMCORE == FALSE
@@ -40,6 +41,11 @@ No further inputs are accepted until DEBOUNCE milliseconds have occurred.
 static debounce_counter_t *debounce_counters;
 static bool                counters_need_update;
 static bool                matrix_need_update;
+static uint8_t             rows_pending[(MATRIX_ROWS + 7) / 8];  // rows with running counters
+
+#define ROW_PENDING(row) (rows_pending[(row) / 8] & (1 << ((row) % 8)))
+#define SET_ROW_PENDING(row) (rows_pending[(row) / 8] |= (1 << ((row) % 8)))
+#define CLEAR_ROW_PENDING(row) (rows_pending[(row) / 8] &= ~(1 << ((row) % 8)))
 
 #define DEBOUNCE_ELAPSED 251
 #define MAX_DEBOUNCE (DEBOUNCE_ELAPSED - 1)
@@ -66,6 +72,9 @@ void debounce_init(uint8_t num_rows) {
             debounce_counters[i++] = DEBOUNCE_ELAPSED;
         }
     }
+    memset(rows_pending, 0, sizeof(rows_pending));
+    counters_need_update = false;
+    matrix_need_update   = false;
 }
 
 void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
@@ -83,16 +92,24 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 void update_debounce_counters(uint8_t num_rows, uint8_t current_time) {
     counters_need_update                 = false;
     debounce_counter_t *debounce_pointer = debounce_counters;
-    for (uint8_t row = 0; row < num_rows; row++) {
+    for (uint8_t row = 0; row < num_rows; row++, debounce_pointer += MATRIX_COLS) {
+        if (!ROW_PENDING(row)) {
+            continue;
+        }
+        bool row_pending = false;
         for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            if (*debounce_pointer != DEBOUNCE_ELAPSED) {
-                if (TIMER_DIFF(current_time, *debounce_pointer, MAX_DEBOUNCE) >= DEBOUNCE) {
-                    *debounce_pointer = DEBOUNCE_ELAPSED;
+            if (debounce_pointer[col] != DEBOUNCE_ELAPSED) {
+                if (TIMER_DIFF(current_time, debounce_pointer[col], MAX_DEBOUNCE) >= DEBOUNCE) {
+                    debounce_pointer[col] = DEBOUNCE_ELAPSED;
                 } else {
-                    counters_need_update = true;
+                    row_pending = true;
                 }
             }
-            debounce_pointer++;
+        }
+        if (row_pending) {
+            counters_need_update = true;
+        } else {
+            CLEAR_ROW_PENDING(row);
         }
     }
 }
@@ -101,24 +118,27 @@ void update_debounce_counters(uint8_t num_rows, uint8_t current_time) {
 void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t current_time) {
     matrix_need_update                   = false;
     debounce_counter_t *debounce_pointer = debounce_counters;
-    for (uint8_t row = 0; row < num_rows; row++) {
-        matrix_row_t delta        = raw[row] ^ cooked[row];
+    for (uint8_t row = 0; row < num_rows; row++, debounce_pointer += MATRIX_COLS) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        if (!delta) {
+            continue;
+        }
         matrix_row_t existing_row = cooked[row];
         for (uint8_t col = 0; col < MATRIX_COLS; col++) {
             matrix_row_t col_mask = (ROW_SHIFTER << col);
             if (delta & col_mask) {
-                if (*debounce_pointer == DEBOUNCE_ELAPSED) {
-                    *debounce_pointer    = current_time;
-                    counters_need_update = true;
+                if (debounce_pointer[col] == DEBOUNCE_ELAPSED) {
+                    debounce_pointer[col] = current_time;
+                    counters_need_update  = true;
+                    SET_ROW_PENDING(row);
                     existing_row ^= col_mask;  // flip the bit.
                 } else {
                     matrix_need_update = true;
                 }
             }
-            debounce_pointer++;
         }
         cooked[row] = existing_row;
     }
 }
 
-bool debounce_active(void) { return true; }
+bool debounce_active(void) { return counters_need_update || matrix_need_update; }
@@ -113,4 +113,4 @@ void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t n
     }
 }
 
-bool debounce_active(void) { return true; }
+bool debounce_active(void) { return counters_need_update || matrix_need_update; }
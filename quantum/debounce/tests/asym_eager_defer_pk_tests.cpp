@@ -0,0 +1,121 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+
+extern "C" uint8_t get_debounce_time(uint8_t row, uint8_t col) {
+    switch (col) {
+        case 3:
+            return 0;
+        case 4:
+            return DEBOUNCE * 2;
+        default:
+            return DEBOUNCE;
+    }
+}
+
+TEST_F(DebounceTest, CleanTap) {
+    addWaveform(0, 1, 0, WAVEFORM_CLEAN_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        {15, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, ChatterTap) {
+    addWaveform(0, 1, 0, WAVEFORM_CHATTER_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        // The release is pushed DEBOUNCE ms after the last bounce
+        {33, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, NoiseSpikeIsHeldForTheLock) {
+    addWaveform(0, 1, 0, WAVEFORM_NOISE_SPIKE);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        {10, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, KeysOnOneRowAreDebouncedSeparately) {
+    addWaveform(0, 1, 0, WAVEFORM_CLEAN_TAP);
+    addWaveform(0, 2, 3, WAVEFORM_CHATTER_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        {3, {}, {{0, 2, DOWN}}},
+        {15, {}, {{0, 1, UP}}},
+        {36, {}, {{0, 2, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, FastScans) {
+    scans_per_ms = 4;
+    addWaveform(0, 1, 0, WAVEFORM_CHATTER_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        {33, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, PerKeyDebounceTime) {
+    // get_debounce_time() below gives column 3 no debounce and column 4 twice the default
+    addWaveform(1, 3, 0, WAVEFORM_CHATTER_TAP);
+    addWaveform(1, 4, 0, WAVEFORM_CHATTER_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{1, 3, DOWN}, {1, 4, DOWN}}},
+        {1, {}, {{1, 3, UP}}},
+        {2, {}, {{1, 3, DOWN}}},
+        {3, {}, {{1, 3, UP}}},
+        {5, {}, {{1, 3, DOWN}}},
+        {6, {}, {{1, 3, UP}}},
+        {7, {}, {{1, 3, DOWN}}},
+        {26, {}, {{1, 3, UP}}},
+        {27, {}, {{1, 3, DOWN}}},
+        {28, {}, {{1, 3, UP}}},
+        {38, {}, {{1, 4, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, LatencyAndChatterRejection) {
+    auto clean = measureWaveform(WAVEFORM_CLEAN_TAP);
+    EXPECT_EQ(clean.press_latency, 0);
+    EXPECT_EQ(clean.release_latency, 5);
+    EXPECT_EQ(clean.transitions, 2);
+
+    auto chatter = measureWaveform(WAVEFORM_CHATTER_TAP);
+    EXPECT_EQ(chatter.press_latency, 0);
+    EXPECT_EQ(chatter.release_latency, 7);
+    EXPECT_EQ(chatter.transitions, 2);
+
+    auto noise = measureWaveform(WAVEFORM_NOISE_SPIKE);
+    EXPECT_EQ(noise.press_latency, 0);
+    EXPECT_EQ(noise.release_latency, 8);
+    EXPECT_EQ(noise.transitions, 2);
+}
@@ -0,0 +1,158 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+extern "C" {
+#include "debounce.h"
+
+void set_time(uint32_t t);
+}
+
+const char *const WAVEFORM_CLEAN_TAP   = "##########_";
+const char *const WAVEFORM_CHATTER_TAP = "#_#__#_###################_#__";
+const char *const WAVEFORM_NOISE_SPIKE = "##_";
+
+void DebounceTest::addEvents(std::initializer_list<DebounceTestEvent> events) {
+    for (const auto &event : events) {
+        auto &merged = events_[event.time];
+        merged.time  = event.time;
+        merged.inputs.insert(merged.inputs.end(), event.inputs.begin(), event.inputs.end());
+        merged.outputs.insert(merged.outputs.end(), event.outputs.begin(), event.outputs.end());
+    }
+}
+
+void DebounceTest::addWaveform(uint8_t row, uint8_t col, uint32_t start, const char *waveform) {
+    bool closed = false;
+    for (uint32_t t = start; *waveform; t++, waveform++) {
+        if ((*waveform == '#') != closed) {
+            closed = !closed;
+            addEvents({{t, {{row, col, closed ? DOWN : UP}}, {}}});
+        }
+    }
+    if (closed) {
+        ADD_FAILURE() << "waveform must end with the key open";
+    }
+}
+
+bool DebounceTest::applyEvents(matrix_row_t matrix[], const std::vector<MatrixTestEvent> &events) {
+    bool changed = false;
+    for (const auto &event : events) {
+        matrix_row_t bit = (matrix_row_t)1 << event.col;
+        if (event.direction == DOWN) {
+            changed |= !(matrix[event.row] & bit);
+            matrix[event.row] |= bit;
+        } else {
+            changed |= !!(matrix[event.row] & bit);
+            matrix[event.row] &= ~bit;
+        }
+    }
+    return changed;
+}
+
+std::string DebounceTest::strMatrix(const matrix_row_t matrix[]) {
+    std::stringstream text;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        text << "\n";
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            text << ((matrix[row] & ((matrix_row_t)1 << col)) ? '#' : '_');
+        }
+    }
+    return text.str();
+}
+
+void DebounceTest::runEvents(void) {
+    matrix_row_t raw[MATRIX_ROWS]      = {0};
+    matrix_row_t cooked[MATRIX_ROWS]   = {0};
+    matrix_row_t expected[MATRIX_ROWS] = {0};
+
+    set_time(0);
+    debounce_init(MATRIX_ROWS);
+
+    uint32_t end = (events_.empty() ? 0 : events_.rbegin()->first) + DEBOUNCE * 4;
+    for (uint32_t time = 0; time <= end; time++) {
+        set_time(time);
+
+        bool changed = false;
+        auto event   = events_.find(time);
+        if (event != events_.end()) {
+            changed = applyEvents(raw, event->second.inputs);
+            applyEvents(expected, event->second.outputs);
+        }
+
+        for (int scan = 0; scan < scans_per_ms; scan++) {
+            debounce(raw, cooked, MATRIX_ROWS, changed && scan == 0);
+
+            if (memcmp(cooked, expected, sizeof(cooked)) != 0) {
+                FAIL() << "Unexpected debounced matrix at " << time << "ms (scan " << scan << ")\nraw:" << strMatrix(raw) << "\ncooked:" << strMatrix(cooked) << "\nexpected:" << strMatrix(expected);
+            }
+
+            // keyboard_task() skips comparing the matrix while the debouncer is idle
+            if (!debounce_active() && memcmp(cooked, raw, sizeof(cooked)) != 0) {
+                FAIL() << "Debounce inactive with changes pending at " << time << "ms (scan " << scan << ")\nraw:" << strMatrix(raw) << "\ncooked:" << strMatrix(cooked);
+            }
+        }
+    }
+}
+
+DebounceMeasurement DebounceTest::measureWaveform(const char *waveform) {
+    matrix_row_t raw[MATRIX_ROWS]    = {0};
+    matrix_row_t cooked[MATRIX_ROWS] = {0};
+
+    // The contact is stable for the longest run of '#', the rest is chatter
+    int    length      = strlen(waveform);
+    int    release     = 0;
+    size_t longest_run = 0;
+    for (int t = 0; t < length; t += 1) {
+        size_t run = strspn(waveform + t, "#");
+        if (run > longest_run) {
+            longest_run = run;
+            release     = t + run;
+        }
+        t += run;
+    }
+
+    DebounceMeasurement result  = {-1, -1, 0};
+    int                 press   = strchr(waveform, '#') ? strchr(waveform, '#') - waveform : 0;
+    matrix_row_t        pressed = 0;
+
+    set_time(0);
+    debounce_init(MATRIX_ROWS);
+    for (int time = 0; time <= length + DEBOUNCE * 4; time++) {
+        set_time(time);
+
+        matrix_row_t level   = time < length && waveform[time] == '#';
+        bool         changed = raw[0] != level;
+        raw[0]               = level;
+
+        for (int scan = 0; scan < scans_per_ms; scan++) {
+            debounce(raw, cooked, MATRIX_ROWS, changed && scan == 0);
+
+            if (cooked[0] != pressed) {
+                pressed = cooked[0];
+                result.transitions++;
+                if (pressed && result.press_latency < 0) result.press_latency = time - press;
+                if (!pressed) result.release_latency = time - release;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,84 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "quantum.h"
+}
+
+enum Direction {
+    DOWN,
+    UP,
+};
+
+struct MatrixTestEvent {
+    uint8_t   row;
+    uint8_t   col;
+    Direction direction;
+};
+
+struct DebounceTestEvent {
+    uint32_t                     time;
+    std::vector<MatrixTestEvent> inputs;
+    std::vector<MatrixTestEvent> outputs;
+};
+
+/* Recorded contact waveforms, one character per millisecond: '#' closed, '_' open */
+extern const char *const WAVEFORM_CLEAN_TAP;
+extern const char *const WAVEFORM_CHATTER_TAP;
+extern const char *const WAVEFORM_NOISE_SPIKE;
+
+/* How one key came through the debounce algorithm, latencies in ms or -1 if never reported */
+struct DebounceMeasurement {
+    int press_latency;    // from the first contact
+    int release_latency;  // from the end of the longest contact
+    int transitions;      // debounced state changes, 2 for a tap with no chatter getting through
+};
+
+class DebounceTest : public ::testing::Test {
+   protected:
+    /* Events are keyed by time, events added at the same time are merged */
+    void addEvents(std::initializer_list<DebounceTestEvent> events);
+
+    /* Adds the input events of a waveform for one key, starting at time start */
+    void addWaveform(uint8_t row, uint8_t col, uint32_t start, const char *waveform);
+
+    /* Scans the matrix scans_per_ms times every millisecond until all events
+     * have happened and DEBOUNCE * 4 more milliseconds have passed, checking
+     * the debounced matrix against the expected outputs after every scan, and
+     * that the debouncer reports itself active whenever it differs from raw.
+     */
+    void runEvents(void);
+
+    /* Runs a waveform on one key on its own and measures the debounced result */
+    DebounceMeasurement measureWaveform(const char *waveform);
+
+    int scans_per_ms = 1;
+
+   private:
+    static bool        applyEvents(matrix_row_t matrix[], const std::vector<MatrixTestEvent> &events);
+    static std::string strMatrix(const matrix_row_t matrix[]);
+
+    std::map<uint32_t, DebounceTestEvent> events_;
+};
@@ -0,0 +1,73 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+
+// sym_defer_g pushes the matrix once more than DEBOUNCE ms have passed without a change
+
+TEST_F(DebounceTest, CleanTap) {
+    addWaveform(0, 1, 0, WAVEFORM_CLEAN_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {6, {}, {{0, 1, DOWN}}},
+        {16, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, ChatterTap) {
+    addWaveform(0, 1, 0, WAVEFORM_CHATTER_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {13, {}, {{0, 1, DOWN}}},
+        {34, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, NoiseSpikeIsIgnored) {
+    addWaveform(0, 1, 0, WAVEFORM_NOISE_SPIKE);
+    runEvents();
+}
+
+TEST_F(DebounceTest, ChatterOnAnyKeyDefersAllKeys) {
+    addWaveform(0, 1, 0, WAVEFORM_CLEAN_TAP);
+    addWaveform(2, 2, 3, WAVEFORM_CHATTER_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        // The tap on (0, 1) is over before the matrix is quiet for DEBOUNCE ms
+        {16, {}, {{2, 2, DOWN}}},
+        {37, {}, {{2, 2, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, LatencyAndChatterRejection) {
+    auto clean = measureWaveform(WAVEFORM_CLEAN_TAP);
+    EXPECT_EQ(clean.press_latency, 6);
+    EXPECT_EQ(clean.release_latency, 6);
+    EXPECT_EQ(clean.transitions, 2);
+
+    auto chatter = measureWaveform(WAVEFORM_CHATTER_TAP);
+    EXPECT_EQ(chatter.press_latency, 13);
+    EXPECT_EQ(chatter.release_latency, 8);
+    EXPECT_EQ(chatter.transitions, 2);
+
+    auto noise = measureWaveform(WAVEFORM_NOISE_SPIKE);
+    EXPECT_EQ(noise.press_latency, -1);
+    EXPECT_EQ(noise.release_latency, -1);
+    EXPECT_EQ(noise.transitions, 0);
+}
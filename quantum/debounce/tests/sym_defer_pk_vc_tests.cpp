@@ -0,0 +1,41 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+
+TEST_F(DebounceTest, WholeRowChattersAtOnce) {
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        addWaveform(2, col, col % 3, WAVEFORM_CHATTER_TAP);
+    }
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        addEvents({
+            /* Time, Inputs, Outputs */
+            {12u + col % 3, {}, {{2, col, DOWN}}},
+            {33u + col % 3, {}, {{2, col, UP}}},
+        });
+    }
+    runEvents();
+}
+
+TEST_F(DebounceTest, LastColumn) {
+    addWaveform(3, MATRIX_COLS - 1, 0, WAVEFORM_CHATTER_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {12, {}, {{3, MATRIX_COLS - 1, DOWN}}},
+        {33, {}, {{3, MATRIX_COLS - 1, UP}}},
+    });
+    runEvents();
+}
@@ -0,0 +1,94 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+
+TEST_F(DebounceTest, CleanTap) {
+    addWaveform(0, 1, 0, WAVEFORM_CLEAN_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        {10, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, ChatterTap) {
+    addWaveform(0, 1, 0, WAVEFORM_CHATTER_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        // The bounce right after the lock runs out gets through
+        {6, {}, {{0, 1, UP}}},
+        {11, {}, {{0, 1, DOWN}}},
+        {26, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, NoiseSpikeIsReported) {
+    addWaveform(0, 1, 0, WAVEFORM_NOISE_SPIKE);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        {5, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, KeysOnOneRowShareTheLock) {
+    addWaveform(0, 1, 0, WAVEFORM_CLEAN_TAP);
+    addWaveform(0, 2, 3, WAVEFORM_CHATTER_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        // (0, 2) went down while the row was locked
+        {5, {}, {{0, 2, DOWN}}},
+        {10, {}, {{0, 1, UP}}},
+        {29, {}, {{0, 2, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, KeysOnOtherRowsAreNotLocked) {
+    addWaveform(0, 1, 0, WAVEFORM_CLEAN_TAP);
+    addWaveform(1, 2, 3, WAVEFORM_CLEAN_TAP);
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {}, {{0, 1, DOWN}}},
+        {3, {}, {{1, 2, DOWN}}},
+        {10, {}, {{0, 1, UP}}},
+        {13, {}, {{1, 2, UP}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, LatencyAndChatterRejection) {
+    auto clean = measureWaveform(WAVEFORM_CLEAN_TAP);
+    EXPECT_EQ(clean.press_latency, 0);
+    EXPECT_EQ(clean.release_latency, 0);
+    EXPECT_EQ(clean.transitions, 2);
+
+    auto chatter = measureWaveform(WAVEFORM_CHATTER_TAP);
+    EXPECT_EQ(chatter.press_latency, 0);
+    EXPECT_EQ(chatter.release_latency, 0);
+    EXPECT_EQ(chatter.transitions, 4);
+
+    auto noise = measureWaveform(WAVEFORM_NOISE_SPIKE);
+    EXPECT_EQ(noise.press_latency, 0);
+    EXPECT_EQ(noise.release_latency, 3);
+    EXPECT_EQ(noise.transitions, 2);
+}
@@ -0,0 +1,7 @@
+TEST_LIST += \
+	debounce_asym_eager_defer_pk \
+	debounce_sym_defer_g \
+	debounce_sym_defer_pk \
+	debounce_sym_defer_pk_vc \
+	debounce_sym_eager_pk \
+	debounce_sym_eager_pr
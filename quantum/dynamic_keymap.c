@@ -116,9 +116,11 @@ void dynamic_keymap_reset(void) {
     }
 }
 
+uint16_t dynamic_keymap_get_buffer_size(void) { return DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2; }
+
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   source                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    uint16_t dynamic_keymap_eeprom_size = dynamic_keymap_get_buffer_size();
+    void *   source                     = (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
     uint8_t *target                     = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < dynamic_keymap_eeprom_size) {
@@ -132,8 +134,8 @@ void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
 }
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   target                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    uint16_t dynamic_keymap_eeprom_size = dynamic_keymap_get_buffer_size();
+    void *   target                     = (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
     uint8_t *source                     = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < dynamic_keymap_eeprom_size) {
@@ -144,6 +146,48 @@ void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
     }
 }
 
+uint8_t dynamic_keymap_get_sparse(uint16_t *position, uint16_t size, uint8_t *data) {
+    uint16_t key_count   = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS;
+    uint16_t key         = *position;
+    uint16_t layer_left  = MATRIX_ROWS * MATRIX_COLS - key % (MATRIX_ROWS * MATRIX_COLS);
+    uint8_t  run         = 0;
+    uint8_t  entry_count = 0;
+    void *   source      = (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + key * 2);
+
+    while (key < key_count && (entry_count + 1) * DYNAMIC_KEYMAP_SPARSE_ENTRY_SIZE <= size) {
+        uint16_t keycode = eeprom_read_byte(source) << 8;
+        keycode |= eeprom_read_byte(source + 1);
+        source += 2;
+        key++;
+        layer_left--;
+
+        if (layer_left && (run & DYNAMIC_KEYMAP_SPARSE_RUN_MAX) < DYNAMIC_KEYMAP_SPARSE_RUN_MAX) {
+            // Runs are of one kind only
+            if (keycode == KC_TRNS && !(run & DYNAMIC_KEYMAP_SPARSE_KC_NO)) {
+                run++;
+                continue;
+            }
+            if (keycode == KC_NO && (!run || (run & DYNAMIC_KEYMAP_SPARSE_KC_NO))) {
+                run = (run + 1) | DYNAMIC_KEYMAP_SPARSE_KC_NO;
+                continue;
+            }
+        }
+
+        *data++ = run;
+        *data++ = keycode >> 8;
+        *data++ = keycode & 0xFF;
+        entry_count++;
+        run = 0;
+        if (!layer_left) {
+            layer_left = MATRIX_ROWS * MATRIX_COLS;
+        }
+    }
+
+    // A run without its entry is read again next time
+    *position = key - (run & DYNAMIC_KEYMAP_SPARSE_RUN_MAX);
+    return entry_count;
+}
+
 // This overrides the one in quantum/keymap_common.c
 uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
     if (layer < DYNAMIC_KEYMAP_LAYER_COUNT && key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
@@ -158,7 +202,7 @@ uint8_t dynamic_keymap_macro_get_count(void) { return DYNAMIC_KEYMAP_MACRO_COUNT
 uint16_t dynamic_keymap_macro_get_buffer_size(void) { return DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE; }
 
 void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   source = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   source = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
     uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
@@ -172,7 +216,7 @@ void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *da
 }
 
 void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   target = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   target = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
     uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
@@ -223,6 +267,15 @@ void dynamic_keymap_macro_send(uint8_t id) {
         ++p;
     }
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+    // The async sender reads the macro straight from EEPROM
+    if (send_string_async_with_delay_E(p, 0)) {
+        return;
+    }
+    // Queue is full: finish what is queued first so the output stays in order
+    send_string_async_flush();
+#endif
+
     // Send the macro string one or three chars at a time
     // by making temporary 1 or 3 char strings
     char data[4] = {0, 0, 0, 0};
@@ -31,8 +31,22 @@ void     dynamic_keymap_reset(void);
 // This is only really useful for host applications that want to get a whole keymap fast,
 // by reading 14 keycodes (28 bytes) at a time, reducing the number of raw HID transfers by
 // a factor of 14.
-void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data);
-void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data);
+uint16_t dynamic_keymap_get_buffer_size(void);
+void     dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data);
+void     dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data);
+
+// Gets the keymaps as a list of the keys that aren't KC_TRNS or KC_NO, which is all
+// a host needs to sync a large keymap whose upper layers are mostly transparent.
+// Keys are numbered by layer/row/column like the buffer, without the *2.
+// Each entry is a run byte followed by a keycode (big-endian). The low 7 bits of the
+// run byte are how many keys before the keycode are KC_TRNS, or KC_NO if the top bit
+// is set. The last key of each layer always gets an entry, so runs don't cross layers.
+// Fills data with as many entries as fit in size bytes, starting at key *position,
+// moves *position past the keys they cover and returns the number of entries.
+#define DYNAMIC_KEYMAP_SPARSE_KC_NO 0x80
+#define DYNAMIC_KEYMAP_SPARSE_RUN_MAX 0x7F
+#define DYNAMIC_KEYMAP_SPARSE_ENTRY_SIZE 3
+uint8_t dynamic_keymap_get_sparse(uint16_t *position, uint16_t size, uint8_t *data);
 
 // This overrides the one in quantum/keymap_common.c
 // uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
@@ -20,6 +20,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debounce.h"
 #include "quantum.h"
+#if defined(readPort) && !defined(DIRECT_PINS) && (DIODE_DIRECTION == COL2ROW)
+#    define MATRIX_READ_COL_PORTS
+#    include "pin_group/pin_group.h"
+#endif
 
 #ifdef DIRECT_PINS
 static pin_t direct_pins[MATRIX_ROWS][MATRIX_COLS] = DIRECT_PINS;
@@ -28,6 +32,10 @@ static const pin_t row_pins[MATRIX_ROWS] = MATRIX_ROW_PINS;
 static const pin_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
 #endif
 
+#ifdef MATRIX_READ_COL_PORTS
+static pin_group_t col_group;
+#endif
+
 /* matrix state(1:on, 0:off) */
 extern matrix_row_t raw_matrix[MATRIX_ROWS];  // raw values
 extern matrix_row_t matrix[MATRIX_ROWS];      // debounced values
@@ -95,6 +103,9 @@ static void init_pins(void) {
     for (uint8_t x = 0; x < MATRIX_COLS; x++) {
         setPinInputHigh_atomic(col_pins[x]);
     }
+#        ifdef MATRIX_READ_COL_PORTS
+    pin_group_init(&col_group, col_pins, MATRIX_COLS);
+#        endif
 }
 
 static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
@@ -105,6 +116,10 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
     select_row(current_row);
     matrix_output_select_delay();
 
+#        ifdef MATRIX_READ_COL_PORTS
+    // Read every col port once (active low)
+    current_row_value = pin_group_read_low(&col_group);
+#        else
     // For each col...
     for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++) {
         // Select the col pin to read (active low)
@@ -113,6 +128,7 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
         // Populate the matrix row with the state of the col pin
         current_row_value |= pin_state ? 0 : (MATRIX_ROW_SHIFTER << col_index);
     }
+#        endif
 
     // Unselect row
     unselect_row(current_row);
@@ -207,7 +223,7 @@ void matrix_init(void) {
     matrix_init_quantum();
 }
 
-uint8_t matrix_scan(void) {
+bool matrix_scan_keys(void) {
     bool changed = false;
 
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
@@ -223,6 +239,11 @@ uint8_t matrix_scan(void) {
 #endif
 
     debounce(raw_matrix, matrix, MATRIX_ROWS, changed);
+    return changed;
+}
+
+uint8_t matrix_scan(void) {
+    bool changed = matrix_scan_keys();
 
     matrix_scan_quantum();
     return (uint8_t)changed;
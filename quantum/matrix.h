@@ -32,6 +32,9 @@ typedef uint32_t matrix_row_t;
 
 #define MATRIX_ROW_SHIFTER ((matrix_row_t)1)
 
+/* column of the first key set in a row, which must not be empty */
+#define MATRIX_ROW_FIRST_COL(row) ((uint8_t)__builtin_ctzl(row))
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -46,6 +49,8 @@ void matrix_setup(void);
 void matrix_init(void);
 /* scan all key states on matrix */
 uint8_t matrix_scan(void);
+/* read and debounce the matrix without running the scan hooks */
+bool matrix_scan_keys(void);
 /* whether modified from previous scan. used after matrix_scan. */
 bool matrix_is_modified(void) __attribute__((deprecated));
 /* whether a switch is on */
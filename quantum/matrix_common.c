@@ -109,10 +109,15 @@ __attribute__((weak)) void matrix_init(void) {
     matrix_init_quantum();
 }
 
-__attribute__((weak)) uint8_t matrix_scan(void) {
+__attribute__((weak)) bool matrix_scan_keys(void) {
     bool changed = matrix_scan_custom(raw_matrix);
 
     debounce(raw_matrix, matrix, MATRIX_ROWS, changed);
+    return changed;
+}
+
+__attribute__((weak)) uint8_t matrix_scan(void) {
+    bool changed = matrix_scan_keys();
 
     matrix_scan_quantum();
     return changed;
@@ -0,0 +1,211 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include "matrix.h"
+#include "i2c_master.h"
+#include "pca9555.h"
+#include "pca9555_matrix.h"
+#include "debug.h"
+
+#ifndef PCA9555_MATRIX_TIMEOUT
+#    define PCA9555_MATRIX_TIMEOUT 100
+#endif
+
+#ifndef PCA9555_MATRIX_MAX_EXPANDERS
+#    define PCA9555_MATRIX_MAX_EXPANDERS 4
+#endif
+
+#define PIN_ADDR(pin) ((pin) >> 4)
+#define PIN_PORT(pin) (((pin) >> 3) & 1)
+#define PIN_MASK(pin) ((uint16_t)1 << ((pin)&0xF))
+#define SLAVE_TO_ADDR(n) ((n) << 1)
+
+#define COMMAND_UNKNOWN 0xFF
+
+// I2C bytes of each kind of transaction, addresses included
+#define WRITE_REG_BYTES(len) (2 + (len))
+#define READ_REG_BYTES(len) (3 + (len))
+#define RECEIVE_BYTES(len) (1 + (len))
+
+typedef struct {
+    uint8_t  addr;     // 7-bit slave address
+    uint8_t  command;  // last command byte sent, where the next read starts
+    uint16_t config;   // configuration registers, port 1 in the high byte
+    uint16_t rows;     // pins wired to rows
+    uint16_t cols;     // pins wired to columns
+} expander_t;
+
+static const uint16_t row_pins[MATRIX_ROWS] = PCA9555_MATRIX_ROW_PINS;
+static const uint16_t col_pins[MATRIX_COLS] = PCA9555_MATRIX_COL_PINS;
+
+static expander_t expanders[PCA9555_MATRIX_MAX_EXPANDERS];
+static uint8_t    expander_count = 0;
+static uint8_t    row_expander[MATRIX_ROWS];
+static uint8_t    col_expander[MATRIX_COLS];
+static uint16_t   scan_bytes = 0;
+
+static uint8_t expander_index(uint8_t addr) {
+    for (uint8_t i = 0; i < expander_count; i++) {
+        if (expanders[i].addr == addr) {
+            return i;
+        }
+    }
+    if (expander_count == PCA9555_MATRIX_MAX_EXPANDERS) {
+        print("pca9555_matrix: too many expanders\n");
+        return 0;
+    }
+    expanders[expander_count] = (expander_t){.addr = addr, .command = COMMAND_UNKNOWN, .config = 0xFFFF};
+    return expander_count++;
+}
+
+static bool write_config(expander_t *expander, uint8_t port, uint16_t config) {
+    uint8_t data = port ? config >> 8 : config & 0xFF;
+    uint8_t cmd  = port ? PCA9555_CMD_CONFIG_1 : PCA9555_CMD_CONFIG_0;
+
+    scan_bytes += WRITE_REG_BYTES(1);
+    if (i2c_writeReg(SLAVE_TO_ADDR(expander->addr), cmd, &data, 1, PCA9555_MATRIX_TIMEOUT) != I2C_STATUS_SUCCESS) {
+        print("pca9555_matrix: select failed\n");
+        expander->command = COMMAND_UNKNOWN;
+        return false;
+    }
+
+    uint16_t mask     = port ? 0xFF00 : 0x00FF;
+    expander->config  = (expander->config & ~mask) | (config & mask);
+    expander->command = cmd;
+    return true;
+}
+
+static bool select_row(uint8_t row) {
+    for (uint8_t i = 0; i < expander_count; i++) {
+        expander_t *expander = &expanders[i];
+        uint16_t    config   = expander->config | expander->rows;
+        if (i == row_expander[row]) {
+            config &= ~PIN_MASK(row_pins[row]);
+        }
+        // Only ports that changed are written, so the previous row is released with the same write
+        uint16_t changed = config ^ expander->config;
+        if ((changed & 0x00FF) && !write_config(expander, 0, config)) return false;
+        if ((changed & 0xFF00) && !write_config(expander, 1, config)) return false;
+    }
+    return true;
+}
+
+static bool read_cols(expander_t *expander, uint16_t *pins) {
+    uint8_t cmd = expander->cols & 0x00FF ? PCA9555_CMD_INPUT_0 : PCA9555_CMD_INPUT_1;
+    uint8_t len = (expander->cols & 0x00FF) && (expander->cols & 0xFF00) ? 2 : 1;
+    uint8_t data[2];
+
+    i2c_status_t ret;
+    if (expander->command == cmd) {
+        scan_bytes += RECEIVE_BYTES(len);
+        ret = i2c_receive(SLAVE_TO_ADDR(expander->addr) | I2C_READ, data, len, PCA9555_MATRIX_TIMEOUT);
+    } else {
+        scan_bytes += READ_REG_BYTES(len);
+        ret = i2c_readReg(SLAVE_TO_ADDR(expander->addr), cmd, data, len, PCA9555_MATRIX_TIMEOUT);
+    }
+    if (ret != I2C_STATUS_SUCCESS) {
+        print("pca9555_matrix: read failed\n");
+        expander->command = COMMAND_UNKNOWN;
+        return false;
+    }
+
+    expander->command = cmd;
+    if (len == 2) {
+        *pins = data[0] | (data[1] << 8);
+    } else {
+        *pins = cmd == PCA9555_CMD_INPUT_0 ? data[0] : data[0] << 8;
+    }
+    return true;
+}
+
+static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
+    uint16_t pins[PCA9555_MATRIX_MAX_EXPANDERS] = {0};
+
+    if (!select_row(current_row)) {
+        // Keep the last good state of the row
+        return false;
+    }
+    // No wait_us() needed, I2C is slow enough for the row to settle
+
+    for (uint8_t i = 0; i < expander_count; i++) {
+        if (expanders[i].cols && !read_cols(&expanders[i], &pins[i])) {
+            // Keep the last good state of the row
+            return false;
+        }
+    }
+
+    matrix_row_t current_row_value = 0;
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (!(pins[col_expander[col]] & PIN_MASK(col_pins[col]))) {
+            current_row_value |= MATRIX_ROW_SHIFTER << col;
+        }
+    }
+
+    if (current_matrix[current_row] == current_row_value) {
+        return false;
+    }
+    current_matrix[current_row] = current_row_value;
+    return true;
+}
+
+void matrix_init_custom(void) {
+    expander_count = 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        row_expander[row] = expander_index(PIN_ADDR(row_pins[row]));
+        expanders[row_expander[row]].rows |= PIN_MASK(row_pins[row]);
+    }
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        col_expander[col] = expander_index(PIN_ADDR(col_pins[col]));
+        expanders[col_expander[col]].cols |= PIN_MASK(col_pins[col]);
+    }
+
+    for (uint8_t i = 0; i < expander_count; i++) {
+        expander_t *expander = &expanders[i];
+        uint16_t    used     = expander->rows | expander->cols;
+
+        // Matrix pins start as inputs, row outputs are latched low and driven by selecting the row
+        pca9555_init(expander->addr);
+        for (uint8_t port = 0; port < 2; port++) {
+            uint8_t shift = port ? 8 : 0;
+            if (!((used >> shift) & 0xFF)) continue;
+            pca9555_set_config(expander->addr, port, ALL_INPUT);
+            if ((expander->rows >> shift) & 0xFF) {
+                pca9555_set_output(expander->addr, port, ALL_LOW);
+            }
+        }
+    }
+}
+
+bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+    bool changed = false;
+
+    scan_bytes = 0;
+    for (uint8_t current_row = 0; current_row < MATRIX_ROWS; current_row++) {
+        changed |= read_cols_on_row(current_matrix, current_row);
+    }
+
+#ifdef DEBUG_MATRIX_SCAN_RATE
+    static uint16_t last_scan_bytes = 0;
+    if (scan_bytes != last_scan_bytes) {
+        dprintf("pca9555_matrix: %u I2C bytes per scan\n", scan_bytes);
+        last_scan_bytes = scan_bytes;
+    }
+#endif
+    return changed;
+}
+
+uint16_t pca9555_matrix_scan_bytes(void) { return scan_bytes; }
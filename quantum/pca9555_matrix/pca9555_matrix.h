@@ -0,0 +1,48 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* Matrix scanning for keyboards wired to PCA9555 I/O expanders, used with
+ * CUSTOM_MATRIX = lite. Rows and columns are listed like MATRIX_ROW_PINS and
+ * MATRIX_COL_PINS, with expander pins:
+ *
+ *   #define PCA9555_MATRIX_ROW_PINS { PCA9555_PIN(0x20, 0, 0), PCA9555_PIN(0x20, 0, 1), ... }
+ *   #define PCA9555_MATRIX_COL_PINS { PCA9555_PIN(0x21, 0, 0), PCA9555_PIN(0x21, 0, 1), ... }
+ *
+ * A row is selected by turning its pin into an output, latched low at init, so
+ * selecting the next row is a single register write. Each expander with columns
+ * is read once per row, both of its ports in one transaction when needed. An
+ * expander keeps its command byte between transactions, so a read from an
+ * expander nobody has written to since its last read skips the command byte
+ * and the repeated start, and only sends its address.
+ */
+
+/* Expander pin: 7-bit slave address, port 0 or 1 and pin 0-7 */
+#define PCA9555_PIN(addr, port, pin) ((uint16_t)(((addr) << 4) | ((port) << 3) | (pin)))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* I2C bytes sent or received during the last scan, addresses included */
+uint16_t pca9555_matrix_scan_bytes(void);
+
+#ifdef __cplusplus
+}
+#endif
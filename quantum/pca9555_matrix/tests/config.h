@@ -0,0 +1,36 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pca9555_matrix.h"
+
+/* Rows on one port of the first expander, columns on both ports of the second
+ * and on the other port of the first
+ */
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 14
+
+#define PCA9555_MATRIX_ROW_PINS \
+    { PCA9555_PIN(0x20, 0, 0), PCA9555_PIN(0x20, 0, 1), PCA9555_PIN(0x20, 0, 2), PCA9555_PIN(0x20, 0, 3) }
+
+#define PCA9555_MATRIX_COL_PINS \
+    { \
+        PCA9555_PIN(0x21, 0, 0), PCA9555_PIN(0x21, 0, 1), PCA9555_PIN(0x21, 0, 2), PCA9555_PIN(0x21, 0, 3), \
+        PCA9555_PIN(0x21, 0, 4), PCA9555_PIN(0x21, 0, 5), PCA9555_PIN(0x21, 0, 6), PCA9555_PIN(0x21, 0, 7), \
+        PCA9555_PIN(0x21, 1, 0), PCA9555_PIN(0x21, 1, 1), \
+        PCA9555_PIN(0x20, 1, 4), PCA9555_PIN(0x20, 1, 5), PCA9555_PIN(0x20, 1, 6), PCA9555_PIN(0x20, 1, 7) \
+    }
@@ -0,0 +1,52 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Mock I2C bus with PCA9555 expanders at addresses 0x20 to 0x27. Input pins
+ * read high unless a closed switch connects them to a pin driven low.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int16_t i2c_status_t;
+
+#define I2C_READ 0x01
+#define I2C_WRITE 0x00
+
+#define I2C_STATUS_SUCCESS (0)
+#define I2C_STATUS_ERROR (-1)
+
+void         i2c_init(void);
+i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
+
+void i2c_mock_reset(void);
+void i2c_mock_set_switch(uint16_t row_pin, uint16_t col_pin, bool closed);
+
+extern uint32_t i2c_mock_bytes;          // bytes on the bus, addresses included
+extern uint8_t  i2c_mock_failures;       // fail this many of the next transactions
+extern uint8_t  i2c_mock_max_driven_low; // most pins driven low while reading
+
+#ifdef __cplusplus
+}
+#endif
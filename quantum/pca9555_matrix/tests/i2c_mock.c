@@ -0,0 +1,143 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "i2c_master.h"
+#include "pca9555.h"
+#include "pca9555_matrix.h"
+
+#define MOCK_EXPANDERS 8
+#define MOCK_SWITCHES 64
+
+typedef struct {
+    uint8_t regs[8];
+    uint8_t command;
+} mock_expander_t;
+
+typedef struct {
+    uint16_t row_pin;
+    uint16_t col_pin;
+} mock_switch_t;
+
+static mock_expander_t expanders[MOCK_EXPANDERS];
+static mock_switch_t   switches[MOCK_SWITCHES];
+static uint8_t         switch_count;
+
+uint32_t i2c_mock_bytes;
+uint8_t  i2c_mock_failures;
+uint8_t  i2c_mock_max_driven_low;
+
+static mock_expander_t *expander(uint8_t address) { return &expanders[((address >> 1) - 0x20) & (MOCK_EXPANDERS - 1)]; }
+
+static bool driven_low(uint16_t pin) {
+    mock_expander_t *e    = &expanders[((pin >> 4) - 0x20) & (MOCK_EXPANDERS - 1)];
+    uint8_t          port = (pin >> 3) & 1;
+    uint8_t          mask = 1 << (pin & 7);
+    return !(e->regs[PCA9555_CMD_CONFIG_0 + port] & mask) && !(e->regs[PCA9555_CMD_OUTPUT_0 + port] & mask);
+}
+
+static uint8_t read_reg(mock_expander_t *e, uint8_t reg) {
+    if (reg > PCA9555_CMD_INPUT_1) {
+        return e->regs[reg];
+    }
+
+    uint8_t  port   = reg - PCA9555_CMD_INPUT_0;
+    uint8_t  config = e->regs[PCA9555_CMD_CONFIG_0 + port];
+    uint8_t  value  = config | (~config & e->regs[PCA9555_CMD_OUTPUT_0 + port]);
+    uint16_t base   = PCA9555_PIN(0x20 + (e - expanders), port, 0);
+    for (uint8_t i = 0; i < switch_count; i++) {
+        if ((switches[i].col_pin & ~7) == base && driven_low(switches[i].row_pin)) {
+            value &= ~(1 << (switches[i].col_pin & 7));
+        }
+    }
+    return value;
+}
+
+static bool transaction(void) {
+    if (i2c_mock_failures) {
+        i2c_mock_failures--;
+        return false;
+    }
+    return true;
+}
+
+static void read_pins(mock_expander_t *e, uint8_t *data, uint16_t length) {
+    uint8_t driven = 0;
+    for (uint8_t i = 0; i < MOCK_EXPANDERS * 16; i++) {
+        driven += driven_low(PCA9555_PIN(0x20 + i / 16, (i >> 3) & 1, i & 7));
+    }
+    if (driven > i2c_mock_max_driven_low) i2c_mock_max_driven_low = driven;
+
+    // Reads alternate between the two registers of a pair
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = read_reg(e, e->command ^ (i & 1));
+    }
+}
+
+void i2c_init(void) {}
+
+i2c_status_t i2c_receive(uint8_t address, uint8_t *data, uint16_t length, uint16_t timeout) {
+    i2c_mock_bytes += 1 + length;
+    if (!transaction()) return I2C_STATUS_ERROR;
+    read_pins(expander(address), data, length);
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    i2c_mock_bytes += 2 + length;
+    if (!transaction()) return I2C_STATUS_ERROR;
+    mock_expander_t *e = expander(devaddr);
+    e->command         = regaddr;
+    for (uint16_t i = 0; i < length; i++) {
+        e->regs[regaddr ^ (i & 1)] = data[i];
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t *data, uint16_t length, uint16_t timeout) {
+    i2c_mock_bytes += 3 + length;
+    if (!transaction()) return I2C_STATUS_ERROR;
+    mock_expander_t *e = expander(devaddr);
+    e->command         = regaddr;
+    read_pins(e, data, length);
+    return I2C_STATUS_SUCCESS;
+}
+
+void i2c_mock_reset(void) {
+    // Power-on state: every pin an input, outputs high
+    for (uint8_t i = 0; i < MOCK_EXPANDERS; i++) {
+        memset(expanders[i].regs, 0xFF, sizeof(expanders[i].regs));
+        expanders[i].regs[PCA9555_CMD_INVERSION_0] = 0;
+        expanders[i].regs[PCA9555_CMD_INVERSION_1] = 0;
+        expanders[i].command                       = 0;
+    }
+    switch_count            = 0;
+    i2c_mock_bytes          = 0;
+    i2c_mock_failures       = 0;
+    i2c_mock_max_driven_low = 0;
+}
+
+void i2c_mock_set_switch(uint16_t row_pin, uint16_t col_pin, bool closed) {
+    for (uint8_t i = 0; i < switch_count; i++) {
+        if (switches[i].row_pin == row_pin && switches[i].col_pin == col_pin) {
+            if (!closed) switches[i] = switches[--switch_count];
+            return;
+        }
+    }
+    if (closed && switch_count < MOCK_SWITCHES) {
+        switches[switch_count++] = (mock_switch_t){row_pin, col_pin};
+    }
+}
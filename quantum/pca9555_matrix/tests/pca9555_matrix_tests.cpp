@@ -0,0 +1,133 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+extern "C" {
+#include "matrix.h"
+#include "i2c_master.h"
+#include "pca9555_matrix.h"
+
+void matrix_init_custom(void);
+bool matrix_scan_custom(matrix_row_t current_matrix[]);
+}
+
+static const uint16_t row_pins[MATRIX_ROWS] = PCA9555_MATRIX_ROW_PINS;
+static const uint16_t col_pins[MATRIX_COLS] = PCA9555_MATRIX_COL_PINS;
+
+class Pca9555MatrixTest : public ::testing::Test {
+   protected:
+    matrix_row_t raw[MATRIX_ROWS];
+    matrix_row_t expected[MATRIX_ROWS];
+
+    void SetUp() override {
+        srand(1);
+        i2c_mock_reset();
+        matrix_init_custom();
+        memset(raw, 0, sizeof(raw));
+        memset(expected, 0, sizeof(expected));
+    }
+
+    void press(uint8_t row, uint8_t col, bool pressed = true) {
+        i2c_mock_set_switch(row_pins[row], col_pins[col], pressed);
+        if (pressed) {
+            expected[row] |= MATRIX_ROW_SHIFTER << col;
+        } else {
+            expected[row] &= ~(MATRIX_ROW_SHIFTER << col);
+        }
+    }
+
+    void expect_matrix(void) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            EXPECT_EQ(raw[row], expected[row]) << "row " << (int)row;
+        }
+    }
+};
+
+TEST_F(Pca9555MatrixTest, ReadsEveryKey) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            press(row, col);
+            EXPECT_TRUE(matrix_scan_custom(raw));
+            expect_matrix();
+
+            press(row, col, false);
+            EXPECT_TRUE(matrix_scan_custom(raw));
+            expect_matrix();
+        }
+    }
+}
+
+TEST_F(Pca9555MatrixTest, ReadsRandomKeys) {
+    for (int i = 0; i < 200; i++) {
+        press(rand() % MATRIX_ROWS, rand() % MATRIX_COLS, rand() % 2);
+        matrix_scan_custom(raw);
+        expect_matrix();
+    }
+    EXPECT_FALSE(matrix_scan_custom(raw));
+    // Rows are selected one at a time
+    EXPECT_EQ(i2c_mock_max_driven_low, 1);
+}
+
+TEST_F(Pca9555MatrixTest, BytesPerScan) {
+    matrix_scan_custom(raw);
+
+    // Per row: a config write to select it (3 bytes), a read of both ports of 0x21 without
+    // a command byte (3 bytes), and a read of 0x20 with one, as selecting moved its pointer (4 bytes)
+    i2c_mock_bytes = 0;
+    matrix_scan_custom(raw);
+    EXPECT_EQ(pca9555_matrix_scan_bytes(), MATRIX_ROWS * 10);
+    EXPECT_EQ(i2c_mock_bytes, pca9555_matrix_scan_bytes());
+
+    // Versus one register read per port (4 bytes each) after selecting the row
+    EXPECT_LT(pca9555_matrix_scan_bytes(), MATRIX_ROWS * (3 + 3 * 4));
+}
+
+TEST_F(Pca9555MatrixTest, RecoversFromFailedTransactions) {
+    press(1, 3);
+    matrix_scan_custom(raw);
+    expect_matrix();
+
+    // Nothing gets through, every row keeps its last state
+    press(1, 3, false);
+    press(2, 12);
+    i2c_mock_failures = 255;
+    EXPECT_FALSE(matrix_scan_custom(raw));
+    EXPECT_EQ(raw[1], MATRIX_ROW_SHIFTER << 3);
+    EXPECT_EQ(raw[2], 0);
+
+    i2c_mock_failures = 0;
+    EXPECT_TRUE(matrix_scan_custom(raw));
+    expect_matrix();
+}
+
+TEST_F(Pca9555MatrixTest, FailedSelectSkipsTheRow) {
+    matrix_scan_custom(raw);
+
+    // The first transaction of a scan selects row 0
+    press(0, 0);
+    press(2, 9);
+    i2c_mock_failures = 1;
+    EXPECT_TRUE(matrix_scan_custom(raw));
+    EXPECT_EQ(raw[0], 0);
+    EXPECT_EQ(raw[2], MATRIX_ROW_SHIFTER << 9);
+    EXPECT_EQ(i2c_mock_max_driven_low, 1);
+
+    EXPECT_TRUE(matrix_scan_custom(raw));
+    expect_matrix();
+}
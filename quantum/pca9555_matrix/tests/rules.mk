@@ -0,0 +1,16 @@
+# The letter case of these variables might seem odd. However:
+# - it is consistent with the serial_link example that is used as a reference in the Unit Testing article (https://docs.qmk.fm/#/unit_testing?id=adding-tests-for-new-or-existing-features)
+# - Neither `make test:pca9555_matrix` or `make test:PCA9555_MATRIX` work when using SCREAMING_SNAKE_CASE
+
+pca9555_matrix_DEFS := -DNO_DEBUG -DNO_PRINT -include $(QUANTUM_PATH)/pca9555_matrix/tests/config.h
+
+pca9555_matrix_INC := \
+	$(QUANTUM_PATH)/pca9555_matrix/tests \
+	$(QUANTUM_PATH)/pca9555_matrix \
+	$(DRIVER_PATH)/gpio
+
+pca9555_matrix_SRC := \
+	$(QUANTUM_PATH)/pca9555_matrix/tests/i2c_mock.c \
+	$(QUANTUM_PATH)/pca9555_matrix/tests/pca9555_matrix_tests.cpp \
+	$(QUANTUM_PATH)/pca9555_matrix/pca9555_matrix.c \
+	$(DRIVER_PATH)/gpio/pca9555.c
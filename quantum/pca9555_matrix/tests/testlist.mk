@@ -0,0 +1 @@
+TEST_LIST += pca9555_matrix
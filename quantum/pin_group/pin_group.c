@@ -0,0 +1,65 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include "pin_group.h"
+
+static uint8_t pin_group_port_index(pin_group_t *group, pin_t pin) {
+    for (uint8_t i = 0; i < group->port_count; i++) {
+        if (getPinPort(group->ports[i]) == getPinPort(pin)) {
+            return i;
+        }
+    }
+    group->ports[group->port_count] = pin;
+    return group->port_count++;
+}
+
+void pin_group_init(pin_group_t *group, const pin_t *pins, uint8_t count) {
+    group->port_count = 0;
+    group->run_count  = 0;
+
+    pin_run_t *run = NULL;
+    for (uint8_t i = 0; i < count && i < PIN_GROUP_MAX_PINS; i++) {
+        uint8_t port = pin_group_port_index(group, pins[i]);
+        uint8_t pad  = getPinPad(pins[i]);
+
+        // Extend the previous run if this pin is the next pad on the same port
+        if (run && run->port == port && run->pad + (i - run->index) == pad) {
+            run->mask = (run->mask << 1) | 1;
+            continue;
+        }
+
+        run        = &group->runs[group->run_count++];
+        run->mask  = 1;
+        run->port  = port;
+        run->pad   = pad;
+        run->index = i;
+    }
+}
+
+uint32_t pin_group_read_low(const pin_group_t *group) {
+    port_data_t values[PIN_GROUP_MAX_PINS];
+    for (uint8_t i = 0; i < group->port_count; i++) {
+        values[i] = ~readPort(group->ports[i]);
+    }
+
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < group->run_count; i++) {
+        const pin_run_t *run = &group->runs[i];
+        result |= (uint32_t)((values[run->port] >> run->pad) & run->mask) << run->index;
+    }
+    return result;
+}
@@ -0,0 +1,59 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "gpio.h"
+
+/* Reads a set of input pins with one register read per GPIO port instead of
+ * one per pin. pin_group_init() sorts the pins by port and splits them into
+ * runs of consecutive pads that map to consecutive pin indexes, so each run is
+ * moved into place with a single shift and mask.
+ *
+ * Needs readPort() and getPinPort()/getPinPad() from the platform's gpio.h.
+ */
+
+#ifndef PIN_GROUP_MAX_PINS
+#    ifdef MATRIX_COLS
+#        define PIN_GROUP_MAX_PINS MATRIX_COLS
+#    else
+#        define PIN_GROUP_MAX_PINS 32
+#    endif
+#endif
+
+#if PIN_GROUP_MAX_PINS > 32
+#    error "PIN_GROUP_MAX_PINS can't be greater than 32"
+#endif
+
+typedef struct {
+    port_data_t mask;   // mask of the run, shifted down to bit 0
+    uint8_t     port;   // index into pin_group_t.ports
+    uint8_t     pad;    // first pad of the run
+    uint8_t     index;  // first pin index of the run
+} pin_run_t;
+
+typedef struct {
+    uint8_t   port_count;
+    uint8_t   run_count;
+    pin_t     ports[PIN_GROUP_MAX_PINS];  // one pin of each port, used to read the whole port
+    pin_run_t runs[PIN_GROUP_MAX_PINS];
+} pin_group_t;
+
+void pin_group_init(pin_group_t *group, const pin_t *pins, uint8_t count);
+
+/* Returns a bitmask with bit n set when pins[n] reads low */
+uint32_t pin_group_read_low(const pin_group_t *group);
@@ -0,0 +1,46 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Mock GPIO: pins are (port << 4) | pad, with up to 16 ports of 16 pads */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint8_t  pin_t;
+typedef uint16_t port_data_t;
+
+#define MOCK_PORTS 16
+#define MOCK_PIN(port, pad) ((pin_t)(((port) << 4) | (pad)))
+
+extern port_data_t mock_ports[MOCK_PORTS];
+extern uint32_t    mock_port_reads;
+
+port_data_t mock_read_port(uint8_t port);
+
+#define getPinPort(pin) ((pin) >> 4)
+#define getPinPad(pin) ((pin)&0xF)
+#define readPort(pin) mock_read_port(getPinPort(pin))
+#define readPin(pin) ((bool)(mock_read_port(getPinPort(pin)) & (1 << getPinPad(pin))))
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,139 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <vector>
+
+extern "C" {
+#include "pin_group/pin_group.h"
+}
+
+class PinGroupTest : public ::testing::Test {
+   protected:
+    pin_group_t group;
+
+    void SetUp() override {
+        srand(1);
+        for (auto &port : mock_ports) port = 0xFFFF;
+        mock_port_reads = 0;
+    }
+
+    void init(const std::vector<pin_t> &pins) {
+        pin_group_init(&group, pins.data(), pins.size());
+        mock_port_reads = 0;
+    }
+
+    // The per pin loop pin_group_read_low replaces in the matrix scan
+    uint32_t read_pins_low(const std::vector<pin_t> &pins) {
+        uint32_t result = 0;
+        for (size_t i = 0; i < pins.size(); i++) {
+            result |= readPin(pins[i]) ? 0 : (1UL << i);
+        }
+        return result;
+    }
+
+    void randomize_ports(void) {
+        for (auto &port : mock_ports) port = rand();
+    }
+
+    // Reads all pins both ways for a number of random port states
+    void expect_same_as_per_pin_reads(const std::vector<pin_t> &pins) {
+        for (int i = 0; i < 100; i++) {
+            randomize_ports();
+            uint32_t expected = read_pins_low(pins);
+            EXPECT_EQ(pin_group_read_low(&group), expected);
+        }
+    }
+};
+
+TEST_F(PinGroupTest, ContiguousPinsAreOneRead) {
+    std::vector<pin_t> pins;
+    for (uint8_t pad = 2; pad < 10; pad++) pins.push_back(MOCK_PIN(1, pad));
+    init(pins);
+
+    EXPECT_EQ(group.port_count, 1U);
+    EXPECT_EQ(group.run_count, 1U);
+
+    mock_ports[1] = ~(1 << 2 | 1 << 5 | 1 << 9);
+    EXPECT_EQ(pin_group_read_low(&group), 0b10001001);
+    EXPECT_EQ(mock_port_reads, 1);
+
+    expect_same_as_per_pin_reads(pins);
+}
+
+TEST_F(PinGroupTest, OnePortReadPerPortPerScan) {
+    // A typical pro micro column layout
+    std::vector<pin_t> pins = {MOCK_PIN(5, 6), MOCK_PIN(5, 7), MOCK_PIN(1, 1), MOCK_PIN(1, 3), MOCK_PIN(1, 2), MOCK_PIN(1, 6), MOCK_PIN(2, 6), MOCK_PIN(4, 6), MOCK_PIN(3, 7), MOCK_PIN(2, 4), MOCK_PIN(1, 4), MOCK_PIN(1, 5)};
+    init(pins);
+
+    EXPECT_EQ(group.port_count, 5U);
+    EXPECT_EQ(group.run_count, 10U);
+
+    pin_group_read_low(&group);
+    EXPECT_EQ(mock_port_reads, 5);
+
+    mock_port_reads = 0;
+    read_pins_low(pins);
+    EXPECT_EQ(mock_port_reads, pins.size());
+
+    expect_same_as_per_pin_reads(pins);
+}
+
+TEST_F(PinGroupTest, ReversedPinsAreSeparateRuns) {
+    std::vector<pin_t> pins;
+    for (int pad = 15; pad >= 0; pad--) pins.push_back(MOCK_PIN(0, pad));
+    init(pins);
+
+    EXPECT_EQ(group.port_count, 1U);
+    EXPECT_EQ(group.run_count, 16U);
+    expect_same_as_per_pin_reads(pins);
+}
+
+TEST_F(PinGroupTest, NothingPressedIsZero) {
+    std::vector<pin_t> pins = {MOCK_PIN(0, 0), MOCK_PIN(0, 15), MOCK_PIN(15, 0), MOCK_PIN(15, 15)};
+    init(pins);
+
+    EXPECT_EQ(pin_group_read_low(&group), 0);
+    for (auto &port : mock_ports) port = 0;
+    EXPECT_EQ(pin_group_read_low(&group), 0b1111);
+}
+
+TEST_F(PinGroupTest, RandomLayoutsMatchPerPinReads) {
+    for (int layout = 0; layout < 200; layout++) {
+        std::vector<pin_t> pins;
+        size_t             count = 1 + rand() % 32;
+        while (pins.size() < count) {
+            // Few ports and neighbouring pads so runs are common
+            pin_t pin = MOCK_PIN(rand() % 4, rand() % 16);
+            if (!pins.empty() && rand() % 2) pin = (pins.back() & 0xF) == 0xF ? pins.back() : pins.back() + 1;
+            bool used = false;
+            for (pin_t p : pins) used |= p == pin;
+            if (!used) pins.push_back(pin);
+        }
+        init(pins);
+
+        uint32_t ports_used = 0;
+        for (pin_t p : pins) ports_used |= 1 << getPinPort(p);
+        EXPECT_EQ(group.port_count, __builtin_popcount(ports_used));
+
+        expect_same_as_per_pin_reads(pins);
+        mock_port_reads = 0;
+        pin_group_read_low(&group);
+        EXPECT_EQ(mock_port_reads, group.port_count);
+    }
+}
@@ -0,0 +1,12 @@
+# The letter case of these variables might seem odd. However:
+# - it is consistent with the serial_link example that is used as a reference in the Unit Testing article (https://docs.qmk.fm/#/unit_testing?id=adding-tests-for-new-or-existing-features)
+# - Neither `make test:pin_group` or `make test:PIN_GROUP` work when using SCREAMING_SNAKE_CASE
+
+pin_group_DEFS := -DNO_DEBUG -DPIN_GROUP_MAX_PINS=32
+
+pin_group_INC := $(QUANTUM_PATH)/pin_group/tests
+
+pin_group_SRC := \
+	$(QUANTUM_PATH)/pin_group/tests/gpio_mock.c \
+	$(QUANTUM_PATH)/pin_group/tests/pin_group_tests.cpp \
+	$(QUANTUM_PATH)/pin_group/pin_group.c
@@ -157,7 +157,7 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     if (drop_buffer) {
         /* buffer is only dropped when we complete a combo, so we refresh the timer
          * here */
-        timer = timer_read();
+        timer = record->event.time;
         dump_key_buffer(false);
     } else if (!is_combo_key) {
         /* if no combos claim the key we need to emit the keybuffer */
@@ -170,7 +170,7 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
         }
     } else if (record->event.pressed && is_active) {
         /* otherwise the key is consumed and placed in the buffer */
-        timer = timer_read();
+        timer = record->event.time;
 
         if (buffer_size < MAX_COMBO_LENGTH) {
 #ifdef COMBO_ALLOW_ACTION_KEYS
@@ -186,6 +186,12 @@ void register_unicode(uint32_t code_point) {
         return;
     }
 
+#ifdef RAW_TEXT_ENABLE
+    if (raw_text_send_code_point(code_point)) {
+        return;
+    }
+#endif
+
     unicode_input_start();
     if (code_point > 0xFFFF && unicode_config.input_mode == UC_MAC) {
         // Convert code point to UTF-16 surrogate pair on macOS
@@ -231,7 +237,7 @@ void send_unicode_hex_string(const char *str) {
 // clang-format on
 
 // Borrowed from https://nullprogram.com/blog/2017/10/06/
-static const char *decode_utf8(const char *str, int32_t *code_point) {
+const char *decode_utf8(const char *str, int32_t *code_point) {
     const char *next;
 
     if (str[0] < 0x80) {  // U+0000-007F
@@ -264,6 +270,12 @@ void send_unicode_string(const char *str) {
         return;
     }
 
+#ifdef RAW_TEXT_ENABLE
+    if (raw_text_send(str)) {
+        return;
+    }
+#endif
+
     while (*str) {
         int32_t code_point = 0;
         str                = decode_utf8(str, &code_point);
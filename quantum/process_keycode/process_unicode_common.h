@@ -93,6 +93,8 @@ void register_unicode(uint32_t code_point);
 void send_unicode_hex_string(const char *str);
 void send_unicode_string(const char *str);
 
+const char *decode_utf8(const char *str, int32_t *code_point);
+
 bool process_unicode_common(uint16_t keycode, keyrecord_t *record);
 
 #define UC_BSPC UC(0x0008)
@@ -181,6 +181,10 @@ void post_process_record_quantum(keyrecord_t *record) {
 bool process_record_quantum(keyrecord_t *record) {
     uint16_t keycode = get_record_keycode(record, true);
 
+#ifdef TRACE_ENABLE
+    trace_event(TRACE_KEYCODE, record->event.pressed, keycode);
+#endif
+
     // This is how you use actions here
     // if (keycode == KC_LEAD) {
     //   action_t action;
@@ -422,6 +426,22 @@ void matrix_scan_quantum() {
     decay_wpm();
 #endif
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+    send_string_task();
+#endif
+
+#ifdef RAW_TEXT_ENABLE
+    raw_text_task();
+#endif
+
+#ifdef TRACE_ENABLE
+    trace_task();
+#endif
+
+#ifdef VIA_ENABLE
+    via_stream_task();
+#endif
+
 #ifdef HAPTIC_ENABLE
     haptic_task();
 #endif
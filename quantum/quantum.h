@@ -189,12 +189,21 @@ extern layer_state_t layer_state;
 
 #ifdef VIA_ENABLE
 #    include "via.h"
+#    include "via_stream.h"
 #endif
 
 #ifdef WPM_ENABLE
 #    include "wpm.h"
 #endif
 
+#ifdef RAW_TEXT_ENABLE
+#    include "raw_text.h"
+#endif
+
+#ifdef TRACE_ENABLE
+#    include "trace.h"
+#endif
+
 #ifdef USBPD_ENABLE
 #    include "usbpd.h"
 #endif
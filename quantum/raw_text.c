@@ -0,0 +1,166 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "raw_text.h"
+#include "raw_hid.h"
+#include "timer.h"
+
+static bool     host_present = false;
+static uint16_t host_timer   = 0;
+
+// Pending text, strings are stored with their null terminator
+static uint8_t  buffer[RAW_TEXT_BUFFER_SIZE];
+static uint16_t buffer_head = 0;
+static uint16_t buffer_used = 0;
+
+// Packet waiting for its acknowledgement
+static uint8_t  packet[RAW_TEXT_PACKET_SIZE];
+static bool     packet_pending = false;
+static uint8_t  packet_length  = 0;
+static uint8_t  packet_seq     = 0;
+static uint16_t packet_timer   = 0;
+static bool     packet_first   = true;
+
+static void buffer_put(uint8_t c) {
+    uint16_t pos = buffer_head + buffer_used++;
+    if (pos >= RAW_TEXT_BUFFER_SIZE) pos -= RAW_TEXT_BUFFER_SIZE;
+    buffer[pos] = c;
+}
+
+static void buffer_drop(uint16_t count) {
+    buffer_head += count;
+    if (buffer_head >= RAW_TEXT_BUFFER_SIZE) buffer_head -= RAW_TEXT_BUFFER_SIZE;
+    buffer_used -= count;
+}
+
+static uint8_t buffer_peek(uint16_t offset) {
+    uint16_t pos = buffer_head + offset;
+    if (pos >= RAW_TEXT_BUFFER_SIZE) pos -= RAW_TEXT_BUFFER_SIZE;
+    return buffer[pos];
+}
+
+/** \brief Handle a raw HID packet meant for the text injection host
+ *
+ * Returns false when the packet belongs to someone else.
+ */
+bool raw_text_receive(uint8_t *data, uint8_t length) {
+    if (length < 3 || data[0] != RAW_TEXT_ID) {
+        return false;
+    }
+
+    switch (data[1]) {
+        case RAW_TEXT_HELLO:
+            host_present = true;
+            host_timer   = timer_read();
+            data[2]      = RAW_TEXT_VERSION;
+            raw_hid_send(data, length);
+            break;
+        case RAW_TEXT_ACK:
+            if (packet_pending && data[2] == packet_seq) {
+                buffer_drop(packet_length);
+                packet_pending = false;
+                packet_first   = false;
+                packet_seq++;
+            }
+            break;
+    }
+    return true;
+}
+
+bool raw_text_host_present(void) { return host_present; }
+
+/** \brief Queue a UTF-8 string for the host to type
+ *
+ * Returns false when no host program is listening or the string doesn't fit in
+ * the buffer, the caller should then type it itself.
+ */
+bool raw_text_send(const char *str) {
+    uint16_t length = strlen(str) + 1;
+    if (!host_present || length > RAW_TEXT_BUFFER_SIZE - buffer_used) {
+        return false;
+    }
+    while (length--) {
+        buffer_put(*str++);
+    }
+    return true;
+}
+
+bool raw_text_send_code_point(uint32_t code_point) {
+    char utf8[5] = {0};
+    if (code_point < 0x80) {
+        utf8[0] = code_point;
+    } else if (code_point < 0x800) {
+        utf8[0] = 0xC0 | (code_point >> 6);
+        utf8[1] = 0x80 | (code_point & 0x3F);
+    } else if (code_point < 0x10000) {
+        utf8[0] = 0xE0 | (code_point >> 12);
+        utf8[1] = 0x80 | ((code_point >> 6) & 0x3F);
+        utf8[2] = 0x80 | (code_point & 0x3F);
+    } else {
+        utf8[0] = 0xF0 | (code_point >> 18);
+        utf8[1] = 0x80 | ((code_point >> 12) & 0x3F);
+        utf8[2] = 0x80 | ((code_point >> 6) & 0x3F);
+        utf8[3] = 0x80 | (code_point & 0x3F);
+    }
+    return raw_text_send(utf8);
+}
+
+void raw_text_task(void) {
+    if (host_present && timer_elapsed(host_timer) > RAW_TEXT_HOST_TIMEOUT) {
+        // Nobody is going to type what is left
+        host_present   = false;
+        packet_pending = false;
+        buffer_used    = 0;
+    }
+
+    if (packet_pending) {
+        if (timer_elapsed(packet_timer) > RAW_TEXT_RETRY_TIME) {
+            raw_hid_send(packet, sizeof(packet));
+            packet_timer = timer_read();
+        }
+        return;
+    }
+    if (!buffer_used) {
+        return;
+    }
+
+    memset(packet, 0, sizeof(packet));
+    packet[0] = RAW_TEXT_ID;
+    packet[1] = RAW_TEXT_DATA;
+    packet[2] = packet_seq;
+
+    uint8_t length = 0;
+    uint8_t flags  = 0;
+    while (length < RAW_TEXT_PAYLOAD_SIZE && length < buffer_used) {
+        uint8_t c = buffer_peek(length);
+        if (!c) {
+            flags = RAW_TEXT_END;
+            break;
+        }
+        packet[4 + length++] = c;
+    }
+    if (packet_first) {
+        flags |= RAW_TEXT_START;
+    }
+    packet[3] = flags | length;
+    // The terminator is consumed along with the last packet of a string
+    packet_length  = length + ((flags & RAW_TEXT_END) ? 1 : 0);
+    packet_pending = true;
+    packet_timer   = timer_read();
+    raw_hid_send(packet, sizeof(packet));
+}
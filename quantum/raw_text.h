@@ -0,0 +1,71 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Raw HID text injection
+ *
+ * UTF-8 text is sent to a host side program (`qmk raw-text`) that types it with
+ * the operating system's own input methods, instead of emitting the unicode input
+ * sequence key by key. Every packet is RAW_TEXT_PACKET_SIZE bytes:
+ *
+ *   host -> keyboard  [RAW_TEXT_ID, RAW_TEXT_HELLO, version]     answered with the same packet
+ *   keyboard -> host  [RAW_TEXT_ID, RAW_TEXT_DATA, seq, flags|length, payload...]
+ *   host -> keyboard  [RAW_TEXT_ID, RAW_TEXT_ACK, seq]
+ *
+ * The host repeats HELLO while it is running, text is only sent while it does.
+ * RAW_TEXT_END in the flags marks the last packet of a string. RAW_TEXT_START
+ * marks the first packet since the keyboard started, whose seq restarts at 0, so
+ * the host doesn't take it for a resent packet.
+ */
+
+#define RAW_TEXT_ID 0xF5
+#define RAW_TEXT_VERSION 2
+#define RAW_TEXT_PACKET_SIZE 32
+#define RAW_TEXT_PAYLOAD_SIZE (RAW_TEXT_PACKET_SIZE - 4)
+#define RAW_TEXT_END 0x80
+#define RAW_TEXT_START 0x40
+#define RAW_TEXT_LENGTH_MASK 0x3F
+
+enum raw_text_command {
+    RAW_TEXT_HELLO = 0x01,
+    RAW_TEXT_DATA  = 0x02,
+    RAW_TEXT_ACK   = 0x03,
+};
+
+/* bytes of text waiting to be acknowledged by the host */
+#ifndef RAW_TEXT_BUFFER_SIZE
+#    define RAW_TEXT_BUFFER_SIZE 128
+#endif
+
+/* the host is considered gone when no HELLO arrived for this long */
+#ifndef RAW_TEXT_HOST_TIMEOUT
+#    define RAW_TEXT_HOST_TIMEOUT 3000
+#endif
+
+/* a packet is sent again when it wasn't acknowledged within this time */
+#ifndef RAW_TEXT_RETRY_TIME
+#    define RAW_TEXT_RETRY_TIME 20
+#endif
+
+bool raw_text_receive(uint8_t *data, uint8_t length);
+bool raw_text_host_present(void);
+bool raw_text_send(const char *str);
+bool raw_text_send_code_point(uint32_t code_point);
+void raw_text_task(void);
@@ -89,6 +89,7 @@ enum rgb_matrix_effects {
     RGB_MATRIX_EFFECT_MAX
 };
 
+void eeconfig_read_rgb_matrix(void);
 void eeconfig_update_rgb_matrix_default(void);
 void eeconfig_update_rgb_matrix(void);
 
@@ -0,0 +1,53 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scan_governor.h"
+#include "keyboard.h"
+#include "timer.h"
+
+static uint16_t last_scan = 0;
+static uint8_t  interval  = 0;
+
+static uint8_t idle_interval(uint32_t idle) {
+    if (idle < SCAN_GOVERNOR_ACTIVE_TIME) {
+        return 0;
+    }
+
+    uint32_t steps = (idle - SCAN_GOVERNOR_ACTIVE_TIME) / SCAN_GOVERNOR_RAMP_TIME;
+    if (steps >= 8 || (1U << steps) > SCAN_GOVERNOR_IDLE_INTERVAL) {
+        return SCAN_GOVERNOR_IDLE_INTERVAL;
+    }
+    return 1U << steps;
+}
+
+bool scan_governor_task(bool active) {
+    uint16_t now = timer_read();
+
+    interval = active ? 0 : idle_interval(last_matrix_activity_elapsed());
+    if (interval && TIMER_DIFF_16(now, last_scan) < interval) {
+        return false;
+    }
+
+    last_scan = now;
+    return true;
+}
+
+uint8_t scan_governor_interval(void) { return interval; }
+
+uint8_t scan_governor_time_to_scan(void) {
+    uint16_t elapsed = timer_elapsed(last_scan);
+    return elapsed < interval ? interval - elapsed : 0;
+}
@@ -0,0 +1,52 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Lowers the matrix scan rate while the keyboard is idle, to save power.
+ *
+ * The matrix is scanned on every keyboard_task() while keys are held, while
+ * the debouncer is busy, and for SCAN_GOVERNOR_ACTIVE_TIME ms after the last
+ * matrix activity. After that the time between scans doubles every
+ * SCAN_GOVERNOR_RAMP_TIME ms, starting at 1 ms, up to SCAN_GOVERNOR_IDLE_INTERVAL.
+ * The time between scans is also the worst case wakeup latency.
+ */
+
+#ifndef SCAN_GOVERNOR_ACTIVE_TIME
+#    define SCAN_GOVERNOR_ACTIVE_TIME 1000
+#endif
+
+#ifndef SCAN_GOVERNOR_RAMP_TIME
+#    define SCAN_GOVERNOR_RAMP_TIME 1000
+#endif
+
+#ifndef SCAN_GOVERNOR_IDLE_INTERVAL
+#    define SCAN_GOVERNOR_IDLE_INTERVAL 8
+#endif
+
+#if SCAN_GOVERNOR_IDLE_INTERVAL > 255
+#    error "SCAN_GOVERNOR_IDLE_INTERVAL can't be greater than 255"
+#endif
+
+/* Whether the matrix is due for a scan. active: keys are held or the debouncer is busy. */
+bool scan_governor_task(bool active);
+/* Milliseconds between scans, 0 when scanning on every task. */
+uint8_t scan_governor_interval(void);
+/* Milliseconds until the next scan is due, 0 when it is due now. */
+uint8_t scan_governor_time_to_scan(void);
@@ -0,0 +1,10 @@
+# The letter case of these variables might seem odd. However:
+# - it is consistent with the serial_link example that is used as a reference in the Unit Testing article (https://docs.qmk.fm/#/unit_testing?id=adding-tests-for-new-or-existing-features)
+# - Neither `make test:scan_governor` or `make test:SCAN_GOVERNOR` work when using SCREAMING_SNAKE_CASE
+
+scan_governor_DEFS := -DNO_DEBUG -DMATRIX_ROWS=1 -DMATRIX_COLS=1
+
+scan_governor_SRC := \
+	$(QUANTUM_PATH)/scan_governor/tests/scan_governor_tests.cpp \
+	$(QUANTUM_PATH)/scan_governor/scan_governor.c \
+	$(TMK_PATH)/common/test/timer.c
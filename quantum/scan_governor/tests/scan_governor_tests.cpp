@@ -0,0 +1,129 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "scan_governor/scan_governor.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+static uint32_t last_activity = 0;
+
+// Stands in for keyboard.c, which keeps the time of the last matrix activity
+uint32_t last_matrix_activity_elapsed(void) { return timer_elapsed32(last_activity); }
+}
+
+class ScanGovernorTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        last_activity = 0;
+        scan_governor_task(false);
+    }
+
+    void activity(void) { last_activity = timer_read32(); }
+
+    // Runs one task per millisecond for ms milliseconds and counts the scans
+    unsigned scans_over(uint32_t ms, bool active = false) {
+        unsigned scans = 0;
+        for (uint32_t i = 0; i < ms; i++) {
+            scans += scan_governor_task(active);
+            advance_time(1);
+        }
+        return scans;
+    }
+
+    // Milliseconds until the next scan, which is how late a key press made now is seen
+    uint32_t wakeup_latency(void) {
+        uint32_t ms = 0;
+        while (!scan_governor_task(false)) {
+            advance_time(1);
+            ms++;
+        }
+        return ms;
+    }
+};
+
+TEST_F(ScanGovernorTest, ScansEveryTaskAfterActivity) {
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(scan_governor_task(false));
+    }
+    EXPECT_EQ(scan_governor_interval(), 0);
+    EXPECT_EQ(scans_over(SCAN_GOVERNOR_ACTIVE_TIME), SCAN_GOVERNOR_ACTIVE_TIME);
+}
+
+TEST_F(ScanGovernorTest, RampsDownToTheIdleInterval) {
+    set_time(SCAN_GOVERNOR_ACTIVE_TIME);
+    scan_governor_task(false);
+    EXPECT_EQ(scan_governor_interval(), 1);
+
+    for (uint8_t expected : {2, 4, 8}) {
+        advance_time(SCAN_GOVERNOR_RAMP_TIME);
+        scan_governor_task(false);
+        EXPECT_EQ(scan_governor_interval(), expected);
+    }
+
+    advance_time(60000);
+    scan_governor_task(false);
+    EXPECT_EQ(scan_governor_interval(), SCAN_GOVERNOR_IDLE_INTERVAL);
+}
+
+TEST_F(ScanGovernorTest, IdleScanRate) {
+    set_time(60000);
+    scans_over(SCAN_GOVERNOR_IDLE_INTERVAL);
+    EXPECT_EQ(scans_over(800), 800 / SCAN_GOVERNOR_IDLE_INTERVAL);
+}
+
+TEST_F(ScanGovernorTest, IdleWakeupLatency) {
+    set_time(60000);
+    uint32_t worst = 0;
+    for (uint32_t offset = 0; offset < 3 * SCAN_GOVERNOR_IDLE_INTERVAL; offset++) {
+        scans_over(offset);
+        worst = std::max(worst, wakeup_latency());
+    }
+    EXPECT_EQ(worst, SCAN_GOVERNOR_IDLE_INTERVAL - 1);
+}
+
+TEST_F(ScanGovernorTest, TimeToScanCountsDownToTheNextScan) {
+    set_time(60000);
+    EXPECT_TRUE(scan_governor_task(false));
+    for (uint8_t left = SCAN_GOVERNOR_IDLE_INTERVAL; left > 0; left--) {
+        EXPECT_EQ(scan_governor_time_to_scan(), left);
+        advance_time(1);
+    }
+    EXPECT_EQ(scan_governor_time_to_scan(), 0);
+    EXPECT_TRUE(scan_governor_task(false));
+}
+
+TEST_F(ScanGovernorTest, HeldKeysKeepTheFullRate) {
+    set_time(60000);
+    scan_governor_task(false);
+    EXPECT_EQ(scans_over(100, true), 100);
+    EXPECT_EQ(scan_governor_interval(), 0);
+}
+
+TEST_F(ScanGovernorTest, ActivityRestoresTheFullRate) {
+    set_time(60000);
+    scan_governor_task(false);
+    EXPECT_EQ(scan_governor_interval(), SCAN_GOVERNOR_IDLE_INTERVAL);
+
+    activity();
+    EXPECT_EQ(scans_over(100), 100);
+    EXPECT_EQ(scan_governor_interval(), 0);
+}
@@ -0,0 +1 @@
+TEST_LIST += scan_governor
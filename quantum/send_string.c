@@ -134,12 +134,76 @@ __attribute__((weak)) const uint8_t ascii_to_keycode_lut[128] PROGMEM = {
 // Note: we bit-pack in "reverse" order to optimize loading
 #define PGM_LOADBIT(mem, pos) ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
 
+#ifdef SENDSTRING_BATCH
+/* Type the run of characters at the start of str that can share a single report.
+ *
+ * HID gives the keys within one report no order. Hosts that go through them in
+ * ascending usage order, as they have to with an NKRO bitmap, type distinct plain
+ * characters with rising keycodes and the same shift state in order. That is up to
+ * the host, which is why this is opt-in. Returns the number of characters typed,
+ * 0 if there's nothing to batch.
+ */
+static uint8_t send_string_batch(const char *str, bool progmem) {
+    uint8_t keycodes[KEYBOARD_REPORT_KEYS];
+    uint8_t count      = 0;
+    bool    is_shifted = false;
+
+    if (has_any_key()) {
+        return 0;
+    }
+
+    while (count < KEYBOARD_REPORT_KEYS) {
+        uint8_t ascii_code = progmem ? pgm_read_byte(str + count) : (uint8_t)str[count];
+        if (ascii_code == 0 || ascii_code == SS_QMK_PREFIX || ascii_code >= 128) break;
+
+        uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[ascii_code]);
+        bool    shifted = PGM_LOADBIT(ascii_to_shift_lut, ascii_code);
+        if (keycode == KC_NO || IS_MOD(keycode) || PGM_LOADBIT(ascii_to_altgr_lut, ascii_code) || PGM_LOADBIT(ascii_to_dead_lut, ascii_code)) break;
+        if (count > 0 && (shifted != is_shifted || keycode <= keycodes[count - 1])) break;
+
+        is_shifted        = shifted;
+        keycodes[count++] = keycode;
+    }
+    if (count < 2) {
+        return 0;
+    }
+
+    if (is_shifted) {
+        register_code(KC_LSFT);
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        add_key(keycodes[i]);
+    }
+    send_keyboard_report();
+#    if TAP_CODE_DELAY > 0
+    wait_ms(TAP_CODE_DELAY);
+#    endif
+    for (uint8_t i = 0; i < count; i++) {
+        del_key(keycodes[i]);
+    }
+    send_keyboard_report();
+    if (is_shifted) {
+        unregister_code(KC_LSFT);
+    }
+    return count;
+}
+#endif
+
 void send_string(const char *str) { send_string_with_delay(str, 0); }
 
 void send_string_P(const char *str) { send_string_with_delay_P(str, 0); }
 
 void send_string_with_delay(const char *str, uint8_t interval) {
     while (1) {
+#ifdef SENDSTRING_BATCH
+        if (!interval) {
+            uint8_t batched = send_string_batch(str, false);
+            if (batched) {
+                str += batched;
+                continue;
+            }
+        }
+#endif
         char ascii_code = *str;
         if (!ascii_code) break;
         if (ascii_code == SS_QMK_PREFIX) {
@@ -181,6 +245,15 @@ void send_string_with_delay(const char *str, uint8_t interval) {
 
 void send_string_with_delay_P(const char *str, uint8_t interval) {
     while (1) {
+#ifdef SENDSTRING_BATCH
+        if (!interval) {
+            uint8_t batched = send_string_batch(str, true);
+            if (batched) {
+                str += batched;
+                continue;
+            }
+        }
+#endif
         char ascii_code = pgm_read_byte(str);
         if (!ascii_code) break;
         if (ascii_code == SS_QMK_PREFIX) {
@@ -304,3 +377,328 @@ void tap_random_base64(void) {
             break;
     }
 }
+
+#ifdef SEND_STRING_ASYNC_ENABLE
+
+#    include <string.h>
+#    include "eeprom.h"
+
+/* Strings queued with the async functions are emitted from send_string_task(), one
+ * report per call, so matrix scanning keeps running while a long macro is typed.
+ * RAM strings and unicode code points are copied into ss_buffer, PROGMEM and EEPROM
+ * strings are read in place.
+ */
+enum send_string_async_source {
+    SS_ASYNC_RAM,
+    SS_ASYNC_PROGMEM,
+    SS_ASYNC_EEPROM,
+    SS_ASYNC_UNICODE,
+};
+
+typedef struct {
+    const char *str;
+    uint8_t     source;
+    uint8_t     interval;
+} ss_async_job_t;
+
+typedef struct {
+    uint8_t  keycode;
+    bool     pressed;
+    uint16_t delay;
+} ss_async_op_t;
+
+static ss_async_job_t ss_jobs[SEND_STRING_ASYNC_QUEUE_SIZE];
+static uint8_t        ss_jobs_head  = 0;
+static uint8_t        ss_jobs_count = 0;
+static ss_async_job_t ss_job;
+static bool           ss_job_active = false;
+
+static char     ss_buffer[SEND_STRING_ASYNC_BUFFER_SIZE];
+static uint16_t ss_buffer_head = 0;
+static uint16_t ss_buffer_used = 0;
+
+// Key presses and releases of the character currently being typed
+static ss_async_op_t ss_ops[8];
+static uint8_t       ss_ops_count = 0;
+static uint8_t       ss_ops_index = 0;
+static uint32_t      ss_next_step = 0;
+
+static void ss_async_buffer_put(char c) {
+    uint16_t pos = ss_buffer_head + ss_buffer_used++;
+    if (pos >= SEND_STRING_ASYNC_BUFFER_SIZE) pos -= SEND_STRING_ASYNC_BUFFER_SIZE;
+    ss_buffer[pos] = c;
+}
+
+static char ss_async_buffer_get(void) {
+    char c = ss_buffer[ss_buffer_head];
+    if (++ss_buffer_head == SEND_STRING_ASYNC_BUFFER_SIZE) ss_buffer_head = 0;
+    ss_buffer_used--;
+    return c;
+}
+
+static bool ss_async_enqueue(const char *str, uint8_t source, uint8_t interval) {
+    if (ss_jobs_count == SEND_STRING_ASYNC_QUEUE_SIZE) {
+        return false;
+    }
+    uint8_t pos = ss_jobs_head + ss_jobs_count++;
+    if (pos >= SEND_STRING_ASYNC_QUEUE_SIZE) pos -= SEND_STRING_ASYNC_QUEUE_SIZE;
+    ss_jobs[pos] = (ss_async_job_t){.str = str, .source = source, .interval = interval};
+    return true;
+}
+
+static char ss_async_read(void) {
+    switch (ss_job.source) {
+        case SS_ASYNC_PROGMEM:
+            return pgm_read_byte(ss_job.str++);
+        case SS_ASYNC_EEPROM:
+            return eeprom_read_byte((const uint8_t *)ss_job.str++);
+        default:
+            return ss_async_buffer_get();
+    }
+}
+
+/* the next byte of the current string, left to be read again */
+static char ss_async_peek(void) {
+    switch (ss_job.source) {
+        case SS_ASYNC_PROGMEM:
+            return pgm_read_byte(ss_job.str);
+        case SS_ASYNC_EEPROM:
+            return eeprom_read_byte((const uint8_t *)ss_job.str);
+        default:
+            return ss_buffer[ss_buffer_head];
+    }
+}
+
+static void ss_async_push_op(uint8_t keycode, bool pressed) { ss_ops[ss_ops_count++] = (ss_async_op_t){.keycode = keycode, .pressed = pressed}; }
+
+static void ss_async_push_tap(uint8_t keycode) {
+    ss_async_push_op(keycode, true);
+    ss_ops[ss_ops_count - 1].delay = keycode == KC_CAPS ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY;
+    ss_async_push_op(keycode, false);
+}
+
+static void ss_async_push_char(char ascii_code) {
+    uint8_t keycode    = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+    bool    is_shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code);
+    bool    is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code);
+    bool    is_dead    = PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code);
+
+    if (is_shifted) ss_async_push_op(KC_LSFT, true);
+    if (is_altgred) ss_async_push_op(KC_RALT, true);
+    ss_async_push_tap(keycode);
+    if (is_altgred) ss_async_push_op(KC_RALT, false);
+    if (is_shifted) ss_async_push_op(KC_LSFT, false);
+    if (is_dead) ss_async_push_tap(KC_SPACE);
+}
+
+static void ss_async_emit_op(void) {
+    ss_async_op_t *op = &ss_ops[ss_ops_index++];
+    if (op->pressed) {
+        register_code(op->keycode);
+    } else {
+        unregister_code(op->keycode);
+    }
+    ss_next_step = timer_read32() + op->delay;
+}
+
+bool send_string_async(const char *str) { return send_string_async_with_delay(str, 0); }
+
+bool send_string_async_P(const char *str) { return send_string_async_with_delay_P(str, 0); }
+
+/** \brief Queue a RAM string
+ *
+ * The string is copied, so it doesn't have to outlive the call. Returns false when there
+ * isn't enough room left in the queue.
+ */
+bool send_string_async_with_delay(const char *str, uint8_t interval) {
+    size_t len = strlen(str) + 1;
+    if (len > SEND_STRING_ASYNC_BUFFER_SIZE - ss_buffer_used || !ss_async_enqueue(NULL, SS_ASYNC_RAM, interval)) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        ss_async_buffer_put(str[i]);
+    }
+    return true;
+}
+
+/** \brief Queue a PROGMEM string
+ *
+ * Returns false when the queue is full.
+ */
+bool send_string_async_with_delay_P(const char *str, uint8_t interval) { return ss_async_enqueue(str, SS_ASYNC_PROGMEM, interval); }
+
+/** \brief Queue a string stored in EEPROM
+ *
+ * The string is read as it is typed, so the EEPROM contents must not change until it has been sent.
+ * Returns false when the queue is full.
+ */
+bool send_string_async_with_delay_E(const uint8_t *addr, uint8_t interval) { return ss_async_enqueue((const char *)addr, SS_ASYNC_EEPROM, interval); }
+
+#    ifdef UNICODE_COMMON_ENABLE
+/** \brief Queue a UTF-8 string for unicode input
+ *
+ * The string is decoded up front and stored as three bytes per code point. Returns false
+ * when there isn't enough room left in the queue.
+ */
+bool send_unicode_string_async(const char *str) {
+    uint16_t    len = 3;
+    const char *p   = str;
+    while (*p) {
+        int32_t code_point = 0;
+        p                  = decode_utf8(p, &code_point);
+        if (code_point > 0) len += 3;
+    }
+    if (len > SEND_STRING_ASYNC_BUFFER_SIZE - ss_buffer_used || !ss_async_enqueue(NULL, SS_ASYNC_UNICODE, 0)) {
+        return false;
+    }
+    while (*str) {
+        int32_t code_point = 0;
+        str                = decode_utf8(str, &code_point);
+        if (code_point > 0) {
+            ss_async_buffer_put(code_point >> 16);
+            ss_async_buffer_put(code_point >> 8);
+            ss_async_buffer_put(code_point);
+        }
+    }
+    // a zero code point ends the string
+    for (uint8_t i = 0; i < 3; i++) {
+        ss_async_buffer_put(0);
+    }
+    return true;
+}
+#    endif
+
+bool send_string_async_busy(void) { return ss_job_active || ss_jobs_count || ss_ops_index < ss_ops_count; }
+
+/** \brief Block until everything queued has been sent
+ */
+void send_string_async_flush(void) {
+    while (send_string_async_busy()) {
+        if (timer_expired32(timer_read32(), ss_next_step)) {
+            send_string_task();
+        } else {
+            wait_ms(1);
+        }
+    }
+}
+
+/** \brief Drop everything queued
+ *
+ * Keys held down by the character being typed are released.
+ */
+void send_string_async_clear(void) {
+    while (ss_ops_index < ss_ops_count) {
+        if (!ss_ops[ss_ops_index].pressed) {
+            unregister_code(ss_ops[ss_ops_index].keycode);
+        }
+        ss_ops_index++;
+    }
+    ss_job_active  = false;
+    ss_jobs_count  = 0;
+    ss_buffer_used = 0;
+}
+
+/** \brief Async send_string task
+ *
+ * Sends at most one report per call, waiting for TAP_CODE_DELAY, SS_DELAY() and the
+ * per-string interval with the timer instead of blocking.
+ */
+void send_string_task(void) {
+    if (!timer_expired32(timer_read32(), ss_next_step)) {
+        return;
+    }
+    if (ss_ops_index < ss_ops_count) {
+        ss_async_emit_op();
+        return;
+    }
+    if (!ss_job_active) {
+        if (!ss_jobs_count) {
+            return;
+        }
+        ss_job = ss_jobs[ss_jobs_head];
+        if (++ss_jobs_head == SEND_STRING_ASYNC_QUEUE_SIZE) ss_jobs_head = 0;
+        ss_jobs_count--;
+        ss_job_active = true;
+    }
+
+#    ifdef UNICODE_COMMON_ENABLE
+    if (ss_job.source == SS_ASYNC_UNICODE) {
+        uint32_t code_point = (uint32_t)(uint8_t)ss_async_buffer_get() << 16;
+        code_point |= (uint16_t)(uint8_t)ss_async_buffer_get() << 8;
+        code_point |= (uint8_t)ss_async_buffer_get();
+        if (!code_point) {
+            ss_job_active = false;
+            return;
+        }
+        register_unicode(code_point);
+        ss_next_step = timer_read32();
+        return;
+    }
+#    endif
+
+    char ascii_code = ss_async_read();
+    if (!ascii_code) {
+        ss_job_active = false;
+        return;
+    }
+
+    uint8_t code = 0;
+    if (ss_job.source == SS_ASYNC_EEPROM) {
+        // Dynamic keymap macros store tap, down and up codes without the prefix
+        if (ascii_code == SS_TAP_CODE || ascii_code == SS_DOWN_CODE || ascii_code == SS_UP_CODE) {
+            code = ascii_code;
+        }
+    } else if (ascii_code == SS_QMK_PREFIX) {
+        code = ss_async_read();
+        if (!code) {
+            // truncated string
+            ss_job_active = false;
+            return;
+        }
+    }
+
+    ss_ops_count = 0;
+    ss_ops_index = 0;
+    ss_next_step = timer_read32();
+    if (code == SS_TAP_CODE || code == SS_DOWN_CODE || code == SS_UP_CODE) {
+        uint8_t keycode = ss_async_read();
+        if (!keycode) {
+            // truncated string
+            ss_job_active = false;
+            return;
+        }
+        if (code == SS_TAP_CODE) {
+            ss_async_push_tap(keycode);
+        } else {
+            ss_async_push_op(keycode, code == SS_DOWN_CODE);
+        }
+    } else if (code == SS_DELAY_CODE) {
+        uint32_t ms = 0;
+        while (isdigit(ss_async_peek())) {
+            ms *= 10;
+            ms += ss_async_read() - '0';
+        }
+        // skip the '|' that ends the delay, a truncated one leaves the terminator to end the string
+        if (ss_async_peek()) {
+            ss_async_read();
+        }
+        ss_next_step += ms;
+    } else if (code) {
+        // unknown code, skip it like send_string() does
+#    if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+    } else if (ascii_code == '\a') {
+        send_char(ascii_code);
+#    endif
+    } else {
+        ss_async_push_char(ascii_code);
+    }
+
+    if (ss_ops_count) {
+        ss_ops[ss_ops_count - 1].delay += ss_job.interval;
+        ss_async_emit_op();
+    } else {
+        ss_next_step += ss_job.interval;
+    }
+}
+
+#endif
@@ -15,6 +15,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "progmem.h"
 #include "send_string_keycodes.h"
@@ -22,6 +23,20 @@
 #define SEND_STRING(string) send_string_P(PSTR(string))
 #define SEND_STRING_DELAY(string, interval) send_string_with_delay_P(PSTR(string), interval)
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+/* number of strings that can be waiting to be sent */
+#    ifndef SEND_STRING_ASYNC_QUEUE_SIZE
+#        define SEND_STRING_ASYNC_QUEUE_SIZE 8
+#    endif
+/* bytes reserved for copies of RAM strings and unicode code points */
+#    ifndef SEND_STRING_ASYNC_BUFFER_SIZE
+#        define SEND_STRING_ASYNC_BUFFER_SIZE 64
+#    endif
+
+#    define SEND_STRING_ASYNC(string) send_string_async_with_delay_P(PSTR(string), 0)
+#    define SEND_STRING_ASYNC_DELAY(string, interval) send_string_async_with_delay_P(PSTR(string), interval)
+#endif
+
 // Look-Up Tables (LUTs) to convert ASCII character to keycode sequence.
 extern const uint8_t ascii_to_shift_lut[16];
 extern const uint8_t ascii_to_altgr_lut[16];
@@ -52,3 +67,18 @@ void send_byte(uint8_t number);
 void send_nibble(uint8_t number);
 
 void tap_random_base64(void);
+
+#ifdef SEND_STRING_ASYNC_ENABLE
+bool send_string_async(const char *str);
+bool send_string_async_with_delay(const char *str, uint8_t interval);
+bool send_string_async_P(const char *str);
+bool send_string_async_with_delay_P(const char *str, uint8_t interval);
+bool send_string_async_with_delay_E(const uint8_t *addr, uint8_t interval);
+#    ifdef UNICODE_COMMON_ENABLE
+bool send_unicode_string_async(const char *str);
+#    endif
+bool send_string_async_busy(void);
+void send_string_async_flush(void);
+void send_string_async_clear(void);
+void send_string_task(void);
+#endif
@@ -0,0 +1,89 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "raw_text.h"
+}
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+static std::vector<std::vector<uint8_t>> sent;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) { sent.emplace_back(data, data + length); }
+
+// Plays the host program, acknowledging every packet and collecting the strings
+class RawTextTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        sent.clear();
+        strings.clear();
+        text.clear();
+        uint8_t hello[RAW_TEXT_PACKET_SIZE] = {RAW_TEXT_ID, RAW_TEXT_HELLO};
+        raw_text_receive(hello, sizeof(hello));
+        sent.clear();
+    }
+
+    void run(unsigned packets) {
+        while (packets--) {
+            raw_text_task();
+            ASSERT_EQ(1u, sent.size());
+            std::vector<uint8_t> packet = sent.front();
+            sent.clear();
+            ASSERT_EQ(RAW_TEXT_ID, packet[0]);
+            ASSERT_EQ(RAW_TEXT_DATA, packet[1]);
+
+            uint8_t length = packet[3] & RAW_TEXT_LENGTH_MASK;
+            text.append((const char *)&packet[4], length);
+            if (packet[3] & RAW_TEXT_END) {
+                strings.push_back(text);
+                text.clear();
+            }
+
+            uint8_t ack[RAW_TEXT_PACKET_SIZE] = {RAW_TEXT_ID, RAW_TEXT_ACK, packet[2]};
+            raw_text_receive(ack, sizeof(ack));
+        }
+        raw_text_task();
+        EXPECT_TRUE(sent.empty());
+    }
+
+    std::vector<std::string> strings;
+    std::string              text;
+};
+
+TEST_F(RawTextTest, LongFirstStringArrivesWhole) {
+    std::string str = "The quick brown fox jumps over the lazy dog";
+    ASSERT_GT(str.size(), (size_t)RAW_TEXT_PAYLOAD_SIZE);
+    EXPECT_TRUE(raw_text_send(str.c_str()));
+    run(2);
+    EXPECT_EQ(std::vector<std::string>({str}), strings);
+}
+
+TEST_F(RawTextTest, StringsFollowingEachOtherArriveWhole) {
+    std::string first  = "first string, long enough to take two packets";
+    std::string second = "second";
+    EXPECT_TRUE(raw_text_send(first.c_str()));
+    EXPECT_TRUE(raw_text_send(second.c_str()));
+    run(3);
+    EXPECT_EQ(std::vector<std::string>({first, second}), strings);
+}
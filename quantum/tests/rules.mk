@@ -0,0 +1,8 @@
+# The letter case of these variables might seem odd. However:
+# - it is consistent with the serial_link example that is used as a reference in the Unit Testing article (https://docs.qmk.fm/#/unit_testing?id=adding-tests-for-new-or-existing-features)
+# - Neither `make test:raw_text` or `make test:RAW_TEXT` work when using SCREAMING_SNAKE_CASE
+
+raw_text_SRC := \
+	$(QUANTUM_PATH)/tests/raw_text_tests.cpp \
+	$(QUANTUM_PATH)/raw_text.c \
+	$(TMK_PATH)/common/test/timer.c
@@ -0,0 +1,172 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "trace.h"
+#include "raw_hid.h"
+#include "timer.h"
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#endif
+
+typedef struct {
+    uint8_t  type;
+    uint8_t  arg8;
+    uint16_t arg16;
+    uint32_t time;
+} trace_record_t;
+
+static bool     host_present = false;
+static uint16_t host_timer   = 0;
+
+static trace_record_t events[TRACE_BUFFER_SIZE];
+static uint8_t        events_head    = 0;
+static uint8_t        events_used    = 0;
+static uint16_t       events_dropped = 0;
+
+static uint8_t  packet_seq  = 0;
+static uint16_t packet_time = 0;
+
+#if TRACE_BUFFER_SIZE > 255
+#    error "TRACE_BUFFER_SIZE can't be greater than 255"
+#endif
+
+/* Microseconds since startup, wrapping every 71 minutes */
+#if defined(__AVR__)
+static uint32_t trace_time(void) {
+    uint8_t  raw;
+    uint32_t ms;
+    do {
+        raw = TIMER_RAW;
+        ms  = timer_read32();
+        // timer0 starting a new millisecond in between would mismatch the two
+    } while (TIMER_RAW < raw);
+    return ms * 1000 + (uint32_t)raw * 1000 / (TIMER_RAW_TOP + 1);
+}
+#elif defined(PROTOCOL_CHIBIOS)
+static uint32_t trace_time(void) {
+    // Ticks are added up as they pass, so a narrow system timer can't wrap
+    // unnoticed while trace_task() runs every scan
+    static systime_t last  = 0;
+    static uint32_t  ticks = 0;
+    systime_t        now   = chVTGetSystemTimeX();
+    ticks += chTimeDiffX(last, now);
+    last = now;
+    return TIME_I2US(ticks);
+}
+#else
+static uint32_t trace_time(void) { return timer_read32() * 1000; }
+#endif
+
+static void put_event(uint8_t type, uint8_t arg8, uint16_t arg16) {
+    uint16_t pos = events_head + events_used++;
+    if (pos >= TRACE_BUFFER_SIZE) pos -= TRACE_BUFFER_SIZE;
+    events[pos] = (trace_record_t){.type = type, .arg8 = arg8, .arg16 = arg16, .time = trace_time()};
+}
+
+/** \brief Handle a raw HID packet meant for the trace host
+ *
+ * Returns false when the packet belongs to someone else.
+ */
+bool trace_receive(uint8_t *data, uint8_t length) {
+    if (length < 3 || data[0] != TRACE_ID) {
+        return false;
+    }
+
+    switch (data[1]) {
+        case TRACE_START:
+            if (!host_present) {
+                events_used    = 0;
+                events_dropped = 0;
+            }
+            host_present = true;
+            host_timer   = timer_read();
+            data[2]      = TRACE_VERSION;
+            raw_hid_send(data, length);
+            break;
+        case TRACE_STOP:
+            host_present = false;
+            break;
+    }
+    return true;
+}
+
+bool trace_active(void) { return host_present; }
+
+/** \brief Record an event, see trace.h for the types
+ *
+ * Does nothing unless a host is listening. When the buffer is full the event is
+ * dropped, and a TRACE_DROPPED event is recorded once there is room again.
+ */
+void trace_event(uint8_t type, uint8_t arg8, uint16_t arg16) {
+    if (!host_present) {
+        return;
+    }
+    if (events_dropped) {
+        if (events_used + 1 >= TRACE_BUFFER_SIZE) {
+            if (events_dropped < UINT16_MAX) events_dropped++;
+            return;
+        }
+        put_event(TRACE_DROPPED, 0, events_dropped);
+        events_dropped = 0;
+    }
+    if (events_used == TRACE_BUFFER_SIZE) {
+        events_dropped = 1;
+        return;
+    }
+    put_event(type, arg8, arg16);
+}
+
+/** \brief Send the recorded events
+ *
+ * One packet per millisecond at most, with as many events as fit. The raw HID
+ * endpoint isn't polled faster, and a packet sent while it is busy is lost.
+ */
+void trace_task(void) {
+    if (!host_present) {
+        return;
+    }
+    if (timer_elapsed(host_timer) > TRACE_HOST_TIMEOUT) {
+        // Nobody is reading the trace any more
+        host_present = false;
+        return;
+    }
+
+    trace_time();
+    if (!events_used || timer_read() == packet_time) {
+        return;
+    }
+
+    uint8_t packet[TRACE_PACKET_SIZE] = {TRACE_ID, TRACE_DATA, packet_seq++};
+    uint8_t count                     = 0;
+    for (uint8_t *p = &packet[4]; count < TRACE_EVENTS_PER_PACKET && events_used; count++, p += TRACE_EVENT_SIZE) {
+        trace_record_t *event = &events[events_head];
+        p[0]                  = event->type;
+        p[1]                  = event->arg8;
+        p[2]                  = event->arg16;
+        p[3]                  = event->arg16 >> 8;
+        p[4]                  = event->time;
+        p[5]                  = event->time >> 8;
+        p[6]                  = event->time >> 16;
+        p[7]                  = event->time >> 24;
+        if (++events_head == TRACE_BUFFER_SIZE) events_head = 0;
+        events_used--;
+    }
+    packet[3]   = count;
+    packet_time = timer_read();
+    raw_hid_send(packet, sizeof(packet));
+}
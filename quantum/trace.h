@@ -0,0 +1,78 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Binary event trace over raw HID
+ *
+ * Key events are recorded with a microsecond timestamp into a buffer that is
+ * streamed to a host side program (`qmk trace`) while it listens. Every packet
+ * is TRACE_PACKET_SIZE bytes:
+ *
+ *   host -> keyboard  [TRACE_ID, TRACE_START, version]         answered with the same packet
+ *   host -> keyboard  [TRACE_ID, TRACE_STOP]
+ *   keyboard -> host  [TRACE_ID, TRACE_DATA, seq, count, events...]
+ *
+ * The host repeats START while it is running, events are only recorded while it
+ * does. Packets aren't acknowledged, a gap in seq means one was lost. Each event
+ * is TRACE_EVENT_SIZE bytes, all little endian:
+ *
+ *   [type, arg8, arg16 (2 bytes), time in us (4 bytes)]
+ *
+ *   TRACE_MATRIX   arg8 = pressed, arg16 = row << 8 | col      a key changed in the matrix
+ *   TRACE_KEYCODE  arg8 = pressed, arg16 = keycode             the keycode a key event resolved to
+ *   TRACE_REPORT   arg8 = mods, arg16 = number of keys         a keyboard report was sent
+ *   TRACE_LAYER    arg8 = highest layer, arg16 = layer state   the layer state changed
+ *   TRACE_DROPPED  arg16 = number of events                    events lost to a full buffer
+ */
+
+#define TRACE_ID 0xF6
+#define TRACE_VERSION 1
+#define TRACE_PACKET_SIZE 32
+#define TRACE_EVENT_SIZE 8
+#define TRACE_EVENTS_PER_PACKET ((TRACE_PACKET_SIZE - 4) / TRACE_EVENT_SIZE)
+
+enum trace_command {
+    TRACE_START = 0x01,
+    TRACE_DATA  = 0x02,
+    TRACE_STOP  = 0x03,
+};
+
+enum trace_event_type {
+    TRACE_MATRIX  = 0x01,
+    TRACE_KEYCODE = 0x02,
+    TRACE_REPORT  = 0x03,
+    TRACE_LAYER   = 0x04,
+    TRACE_DROPPED = 0x05,
+};
+
+/* events waiting to be sent */
+#ifndef TRACE_BUFFER_SIZE
+#    define TRACE_BUFFER_SIZE 32
+#endif
+
+/* tracing stops when no START arrived for this long */
+#ifndef TRACE_HOST_TIMEOUT
+#    define TRACE_HOST_TIMEOUT 3000
+#endif
+
+bool trace_receive(uint8_t *data, uint8_t length);
+bool trace_active(void);
+void trace_event(uint8_t type, uint8_t arg8, uint16_t arg16);
+void trace_task(void);
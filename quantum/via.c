@@ -41,6 +41,7 @@
 #include "quantum.h"
 
 #include "via.h"
+#include "via_stream.h"
 
 #include "raw_hid.h"
 #include "dynamic_keymap.h"
@@ -101,6 +102,39 @@ void via_eeprom_reset(void) {
 // the caller also needs to check the valid state.
 __attribute__((weak)) void via_init_kb(void) {}
 
+// The matrix as last reported to the host, switch matrix changes are sent against it.
+static matrix_row_t via_matrix[MATRIX_ROWS];
+
+static void via_matrix_snapshot(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        via_matrix[row] = matrix_get_row(row);
+    }
+}
+
+// Fills data[0] with the number of changes and data[1..] with (row, col | 0x80 if pressed) pairs.
+// Bit 7 of the count is set when more changes are left for the next request.
+static void via_matrix_get_changes(uint8_t *data, uint8_t length) {
+    uint8_t max   = (length - 1) / 2;
+    uint8_t count = 0;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t row_data = matrix_get_row(row);
+        for (matrix_row_t change = row_data ^ via_matrix[row]; change; change &= change - 1) {
+            if (count == max) {
+                data[0] = count | 0x80;
+                return;
+            }
+            uint8_t      col      = MATRIX_ROW_FIRST_COL(change);
+            matrix_row_t col_mask = MATRIX_ROW_SHIFTER << col;
+            data[1 + count * 2]   = row;
+            data[2 + count * 2]   = col | ((row_data & col_mask) ? 0x80 : 0);
+            via_matrix[row] ^= col_mask;
+            count++;
+        }
+    }
+    data[0] = count;
+}
+
 // Called by QMK core to initialize dynamic keymaps etc.
 void via_init(void) {
     // Let keyboard level test EEPROM valid state,
@@ -203,6 +237,19 @@ __attribute__((weak)) void raw_hid_receive_kb(uint8_t *data, uint8_t length) {
 void raw_hid_receive(uint8_t *data, uint8_t length) {
     uint8_t *command_id   = &(data[0]);
     uint8_t *command_data = &(data[1]);
+#ifdef RAW_TEXT_ENABLE
+    if (raw_text_receive(data, length)) {
+        return;
+    }
+#endif
+#ifdef TRACE_ENABLE
+    if (trace_receive(data, length)) {
+        return;
+    }
+#endif
+    if (via_stream_receive(data, length)) {
+        return;
+    }
     switch (*command_id) {
         case id_get_protocol_version: {
             command_data[0] = VIA_PROTOCOL_VERSION >> 8;
@@ -243,9 +290,24 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
 #    endif
                         command_data[i++] = value & 0xFF;
                     }
+                    via_matrix_snapshot();
 #endif
                     break;
                 }
+                case id_switch_matrix_changes: {
+                    via_matrix_get_changes(&command_data[1], length - 2);
+                    break;
+                }
+#ifndef NO_ACTION_TAPPING
+                case id_tapping_buffer_stats: {
+                    uint16_t value  = action_tapping_get_overflow_count();
+                    command_data[1] = value >> 8;
+                    command_data[2] = value & 0xFF;
+                    command_data[3] = action_tapping_get_buffer_peak();
+                    command_data[4] = WAITING_BUFFER_SIZE - 1;
+                    break;
+                }
+#endif
                 default: {
                     raw_hid_receive_kb(data, length);
                     break;
@@ -371,6 +433,14 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             dynamic_keymap_set_buffer(offset, size, &command_data[3]);
             break;
         }
+        case id_dynamic_keymap_get_sparse: {
+            // Position of the first key in, and of the first key not covered out
+            uint16_t position = (command_data[0] << 8) | command_data[1];
+            command_data[2]   = dynamic_keymap_get_sparse(&position, length - 4, &command_data[3]);
+            command_data[0]   = position >> 8;
+            command_data[1]   = position & 0xFF;
+            break;
+        }
         default: {
             // The command ID is not known
             // Return the unhandled state
@@ -78,13 +78,17 @@ enum via_command_id {
     id_dynamic_keymap_get_layer_count       = 0x11,
     id_dynamic_keymap_get_buffer            = 0x12,
     id_dynamic_keymap_set_buffer            = 0x13,
+    id_dynamic_keymap_get_sparse            = 0x14,
+    id_stream                               = 0x80,  // see via_stream.h
     id_unhandled                            = 0xFF,
 };
 
 enum via_keyboard_value_id {
-    id_uptime              = 0x01,  //
-    id_layout_options      = 0x02,
-    id_switch_matrix_state = 0x03
+    id_uptime                = 0x01,  //
+    id_layout_options        = 0x02,
+    id_switch_matrix_state   = 0x03,
+    id_tapping_buffer_stats  = 0x04,
+    id_switch_matrix_changes = 0x05,
 };
 
 enum via_lighting_value {
@@ -0,0 +1,270 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "quantum.h"
+
+#include "via.h"
+#include "via_stream.h"
+#include "raw_hid.h"
+#include "dynamic_keymap.h"
+#include "tmk_core/common/eeprom.h"
+#include "timer.h"
+
+#define VIA_STREAM_PACKET_SIZE (VIA_STREAM_PAYLOAD_SIZE + 4)
+
+// A read is dropped when the host stops acknowledging, after going back this many times
+#define VIA_STREAM_MAX_RETRIES 20
+
+// The lighting region is the backlight (1 byte), rgblight (4) and rgb_matrix (5)
+// settings back to back, as they are kept in EEPROM
+#define VIA_STREAM_LIGHTING_SIZE 10
+
+// The transfer in progress, counted in packets
+static struct {
+    uint8_t  region;  // 0 when no transfer is open
+    bool     write;
+    uint8_t  window;
+    uint16_t offset;
+    uint16_t length;
+    uint16_t packets;
+    uint16_t acked;  // packets acknowledged by the host, or taken in order from it
+    uint16_t next;   // next packet to send to the host
+    uint16_t timer;  // last progress, or the last gap reported to the host
+    uint16_t sent_time;
+    uint8_t  retries;
+    bool     gap_reported;
+} stream;
+
+static bool region_size(uint8_t region, uint16_t *size) {
+    switch (region) {
+        case VIA_STREAM_KEYMAP:
+            *size = dynamic_keymap_get_buffer_size();
+            return true;
+        case VIA_STREAM_MACROS:
+            *size = dynamic_keymap_macro_get_buffer_size();
+            return true;
+        case VIA_STREAM_CUSTOM_CONFIG:
+            *size = VIA_EEPROM_CUSTOM_CONFIG_SIZE;
+            return true;
+        case VIA_STREAM_LIGHTING:
+            *size = VIA_STREAM_LIGHTING_SIZE;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static uint8_t *lighting_address(uint16_t offset) {
+    if (offset < 1) return EECONFIG_BACKLIGHT;
+    if (offset < 5) return (uint8_t *)EECONFIG_RGBLIGHT + offset - 1;
+    return (uint8_t *)EECONFIG_RGB_MATRIX + offset - 5;
+}
+
+// Applies lighting settings written to EEPROM straight away
+static void lighting_reload(void) {
+#ifdef BACKLIGHT_ENABLE
+    backlight_init();
+#endif
+#ifdef RGBLIGHT_ENABLE
+    rgblight_reload_from_eeprom();
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    eeconfig_read_rgb_matrix();
+#endif
+}
+
+static void region_read(uint16_t offset, uint8_t size, uint8_t *data) {
+    switch (stream.region) {
+        case VIA_STREAM_KEYMAP:
+            dynamic_keymap_get_buffer(offset, size, data);
+            break;
+        case VIA_STREAM_MACROS:
+            dynamic_keymap_macro_get_buffer(offset, size, data);
+            break;
+        case VIA_STREAM_CUSTOM_CONFIG:
+            eeprom_read_block(data, (uint8_t *)VIA_EEPROM_CUSTOM_CONFIG_ADDR + offset, size);
+            break;
+        case VIA_STREAM_LIGHTING:
+            for (uint8_t i = 0; i < size; i++) {
+                data[i] = eeprom_read_byte(lighting_address(offset + i));
+            }
+            break;
+    }
+}
+
+static void region_write(uint16_t offset, uint8_t size, uint8_t *data) {
+    switch (stream.region) {
+        case VIA_STREAM_KEYMAP:
+            dynamic_keymap_set_buffer(offset, size, data);
+            break;
+        case VIA_STREAM_MACROS:
+            dynamic_keymap_macro_set_buffer(offset, size, data);
+            break;
+        case VIA_STREAM_CUSTOM_CONFIG:
+            eeprom_update_block(data, (uint8_t *)VIA_EEPROM_CUSTOM_CONFIG_ADDR + offset, size);
+            break;
+        case VIA_STREAM_LIGHTING:
+            for (uint8_t i = 0; i < size; i++) {
+                eeprom_update_byte(lighting_address(offset + i), data[i]);
+            }
+            lighting_reload();
+            break;
+    }
+}
+
+static uint8_t packet_size(uint16_t packet) {
+    uint16_t left = stream.length - packet * VIA_STREAM_PAYLOAD_SIZE;
+    return left < VIA_STREAM_PAYLOAD_SIZE ? left : VIA_STREAM_PAYLOAD_SIZE;
+}
+
+static void send_ack(uint8_t seq, uint8_t status) {
+    uint8_t packet[VIA_STREAM_PACKET_SIZE] = {id_stream, VIA_STREAM_ACK, seq, status};
+    raw_hid_send(packet, sizeof(packet));
+}
+
+static uint8_t open_stream(uint8_t *data) {
+    uint8_t  region = data[2];
+    uint16_t offset = (data[4] << 8) | data[5];
+    uint16_t length = (data[6] << 8) | data[7];
+    uint16_t size;
+
+    stream.region = 0;
+    if (!region_size(region, &size)) {
+        return VIA_STREAM_BAD_REGION;
+    }
+    if (!length || offset > size || length > size - offset) {
+        return VIA_STREAM_BAD_RANGE;
+    }
+
+    memset(&stream, 0, sizeof(stream));
+    stream.region  = region;
+    stream.write   = data[3] & VIA_STREAM_WRITE;
+    stream.window  = data[8] && data[8] < VIA_STREAM_WINDOW ? data[8] : VIA_STREAM_WINDOW;
+    stream.offset  = offset;
+    stream.length  = length;
+    stream.packets = (length + VIA_STREAM_PAYLOAD_SIZE - 1) / VIA_STREAM_PAYLOAD_SIZE;
+    stream.timer   = timer_read();
+    return VIA_STREAM_OK;
+}
+
+/* Takes packets from the host in order and reports gaps */
+static void receive_data(uint8_t *data) {
+    uint8_t seq = data[2];
+
+    if (stream.acked == stream.packets) {
+        // The host missed the last acknowledgement
+        send_ack(stream.packets - 1, VIA_STREAM_DONE);
+        return;
+    }
+    if (seq != (uint8_t)stream.acked) {
+        // Missing packets, or ones sent again. Tell the host where to resume,
+        // again if it still hasn't after a while
+        if (!stream.gap_reported || timer_elapsed(stream.timer) >= VIA_STREAM_RETRY_TIME / 2) {
+            stream.gap_reported = true;
+            stream.timer        = timer_read();
+            send_ack(stream.acked - 1, VIA_STREAM_OK);
+        }
+        return;
+    }
+
+    region_write(stream.offset + stream.acked * VIA_STREAM_PAYLOAD_SIZE, packet_size(stream.acked), &data[4]);
+    stream.acked++;
+    stream.gap_reported = false;
+    if (stream.acked == stream.packets) {
+        send_ack(seq, VIA_STREAM_DONE);
+    } else if (stream.acked % stream.window == 0) {
+        send_ack(seq, VIA_STREAM_OK);
+    }
+}
+
+/* Moves the window on, or back to the first packet not acknowledged */
+static void receive_ack(uint8_t *data) {
+    uint8_t newly_acked = (uint8_t)(data[2] - (uint8_t)stream.acked) + 1;
+
+    if (newly_acked && newly_acked <= stream.next - stream.acked) {
+        stream.acked += newly_acked;
+        stream.retries = 0;
+    } else {
+        stream.next = stream.acked;
+    }
+    stream.timer = timer_read();
+}
+
+/** \brief Handle a stream packet from the host
+ *
+ * Returns false when the packet belongs to someone else.
+ */
+bool via_stream_receive(uint8_t *data, uint8_t length) {
+    if (length < VIA_STREAM_PACKET_SIZE || data[0] != id_stream) {
+        return false;
+    }
+
+    switch (data[1]) {
+        case VIA_STREAM_OPEN:
+            data[2] = open_stream(data);
+            data[3] = stream.window;
+            data[4] = VIA_STREAM_PAYLOAD_SIZE;
+            raw_hid_send(data, length);
+            break;
+        case VIA_STREAM_DATA:
+            if (stream.region && stream.write) {
+                receive_data(data);
+            } else {
+                send_ack(data[2], VIA_STREAM_NOT_OPEN);
+            }
+            break;
+        case VIA_STREAM_ACK:
+            if (stream.region && !stream.write) {
+                receive_ack(data);
+            }
+            break;
+        case VIA_STREAM_CLOSE:
+            stream.region = 0;
+            raw_hid_send(data, length);
+            break;
+    }
+    return true;
+}
+
+/** \brief Send the next packet of a read
+ *
+ * One packet per millisecond at most, the raw HID endpoint isn't polled faster.
+ */
+void via_stream_task(void) {
+    if (!stream.region || stream.write || stream.acked == stream.packets) {
+        return;
+    }
+    if (stream.next != stream.acked && timer_elapsed(stream.timer) >= VIA_STREAM_RETRY_TIME) {
+        // Nothing was acknowledged for too long, go back
+        if (++stream.retries > VIA_STREAM_MAX_RETRIES) {
+            stream.region = 0;
+            return;
+        }
+        stream.next  = stream.acked;
+        stream.timer = timer_read();
+    }
+    if (stream.next == stream.packets || stream.next - stream.acked >= stream.window || timer_read() == stream.sent_time) {
+        return;
+    }
+
+    uint8_t packet[VIA_STREAM_PACKET_SIZE] = {id_stream, VIA_STREAM_DATA, stream.next, packet_size(stream.next)};
+    region_read(stream.offset + stream.next * VIA_STREAM_PAYLOAD_SIZE, packet[3], &packet[4]);
+    raw_hid_send(packet, sizeof(packet));
+    stream.next++;
+    stream.sent_time = timer_read();
+}
@@ -0,0 +1,88 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Streamed bulk transfers for VIA
+ *
+ * Reads and writes a whole region, like the dynamic keymap, as a stream of
+ * packets with up to a window of them in flight, instead of one request and
+ * reply per 28 bytes. Every packet starts with id_stream:
+ *
+ *   host -> keyboard  [id_stream, VIA_STREAM_OPEN, region, flags, offset (2), length (2), window]
+ *   keyboard -> host  [id_stream, VIA_STREAM_OPEN, status, window, payload size]
+ *   either way        [id_stream, VIA_STREAM_DATA, seq, size, payload...]
+ *   either way        [id_stream, VIA_STREAM_ACK, seq, status]
+ *   host -> keyboard  [id_stream, VIA_STREAM_CLOSE]
+ *
+ * Offsets and lengths are big endian like the rest of VIA. VIA_STREAM_WRITE in
+ * the flags makes it a write. The window granted may be smaller than the one
+ * asked for.
+ *
+ * The sender numbers DATA packets from 0, wrapping at 256, and keeps up to a
+ * window of them unacknowledged. The receiver acknowledges the last packet it
+ * took in order: the keyboard at the end of every window, at the end of the
+ * transfer and when it sees a gap; the host as often as it likes. Packets
+ * after a gap are thrown away, and the sender goes back to the first packet
+ * not acknowledged when told about a gap or when no acknowledgement came for
+ * VIA_STREAM_RETRY_TIME. The status of the last ACK is VIA_STREAM_DONE once the
+ * whole transfer made it.
+ */
+
+#define VIA_STREAM_PAYLOAD_SIZE 28
+#define VIA_STREAM_WRITE 0x01
+
+enum via_stream_command {
+    VIA_STREAM_OPEN  = 0x01,
+    VIA_STREAM_DATA  = 0x02,
+    VIA_STREAM_ACK   = 0x03,
+    VIA_STREAM_CLOSE = 0x04,
+};
+
+enum via_stream_region {
+    VIA_STREAM_KEYMAP        = 0x01,  // dynamic keymap, as in id_dynamic_keymap_get_buffer
+    VIA_STREAM_MACROS        = 0x02,  // macro buffer, as in id_dynamic_keymap_macro_get_buffer
+    VIA_STREAM_CUSTOM_CONFIG = 0x03,  // keyboard level EEPROM, VIA_EEPROM_CUSTOM_CONFIG_SIZE bytes
+    VIA_STREAM_LIGHTING      = 0x04,  // backlight, rgblight and rgb_matrix settings, applied when written
+};
+
+enum via_stream_status {
+    VIA_STREAM_OK         = 0x00,
+    VIA_STREAM_DONE       = 0x01,
+    VIA_STREAM_BAD_REGION = 0x02,
+    VIA_STREAM_BAD_RANGE  = 0x03,
+    VIA_STREAM_NOT_OPEN   = 0x04,
+};
+
+/* most packets in flight, and the window granted when the host asks for more */
+#ifndef VIA_STREAM_WINDOW
+#    define VIA_STREAM_WINDOW 8
+#endif
+
+/* packets that weren't acknowledged within this many ms are sent again */
+#ifndef VIA_STREAM_RETRY_TIME
+#    define VIA_STREAM_RETRY_TIME 50
+#endif
+
+#if VIA_STREAM_WINDOW < 1 || VIA_STREAM_WINDOW > 127
+#    error "VIA_STREAM_WINDOW must be between 1 and 127"
+#endif
+
+bool via_stream_receive(uint8_t *data, uint8_t length);
+void via_stream_task(void);
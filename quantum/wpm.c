@@ -17,13 +17,18 @@
 
 #include "wpm.h"
 
+#if WPM_WINDOW_KEYS < 2 || WPM_WINDOW_KEYS > 255
+#    error "WPM_WINDOW_KEYS must be between 2 and 255"
+#endif
+
 // WPM Stuff
-static uint8_t  current_wpm = 0;
-static uint8_t  latest_wpm  = 0;
-static uint16_t wpm_timer   = 0;
+static uint8_t  current_wpm      = 0;
+static uint16_t wpm_update_timer = 0;
 
-// This smoothing is 40 keystrokes
-static const float wpm_smoothing = 0.0487;
+// Timestamps of the last WPM_WINDOW_KEYS keystrokes
+static uint16_t wpm_keys[WPM_WINDOW_KEYS];
+static uint8_t  wpm_keys_head  = 0;
+static uint8_t  wpm_keys_count = 0;
 
 void set_current_wpm(uint8_t new_wpm) { current_wpm = new_wpm; }
 
@@ -48,17 +53,42 @@ __attribute__((weak)) bool wpm_keycode_user(uint16_t keycode) {
 
 void update_wpm(uint16_t keycode) {
     if (wpm_keycode(keycode)) {
-        if (wpm_timer > 0) {
-            latest_wpm  = 60000 / timer_elapsed(wpm_timer) / 5;
-            current_wpm = (latest_wpm - current_wpm) * wpm_smoothing + current_wpm;
-        }
-        wpm_timer = timer_read();
+        wpm_keys[wpm_keys_head] = timer_read();
+        if (++wpm_keys_head == WPM_WINDOW_KEYS) wpm_keys_head = 0;
+        if (wpm_keys_count < WPM_WINDOW_KEYS) wpm_keys_count++;
     }
 }
 
+/* Recompute the WPM every WPM_UPDATE_INTERVAL from the keystrokes of the last
+ * WPM_WINDOW_MS: (keystrokes - 1) / 5 words over the time they span. Once the
+ * pause after the last keystroke outgrows the average gap between keystrokes it
+ * is added to the span too, so the WPM falls off smoothly when typing stops.
+ */
 void decay_wpm(void) {
-    if (timer_elapsed(wpm_timer) > 1000) {
-        current_wpm = (0 - current_wpm) * wpm_smoothing + current_wpm;
-        wpm_timer   = timer_read();
+    if (timer_elapsed(wpm_update_timer) < WPM_UPDATE_INTERVAL) {
+        return;
     }
+    wpm_update_timer = timer_read();
+
+    uint8_t oldest = wpm_keys_head >= wpm_keys_count ? wpm_keys_head - wpm_keys_count : wpm_keys_head + WPM_WINDOW_KEYS - wpm_keys_count;
+    while (wpm_keys_count && timer_elapsed(wpm_keys[oldest]) > WPM_WINDOW_MS) {
+        if (++oldest == WPM_WINDOW_KEYS) oldest = 0;
+        wpm_keys_count--;
+    }
+
+    if (wpm_keys_count < 2) {
+        current_wpm = 0;
+        return;
+    }
+
+    uint8_t  newest = wpm_keys_head ? wpm_keys_head - 1 : WPM_WINDOW_KEYS - 1;
+    uint16_t span   = TIMER_DIFF_16(wpm_keys[newest], wpm_keys[oldest]);
+    uint16_t gap    = span / (wpm_keys_count - 1);
+    uint16_t idle   = timer_elapsed(wpm_keys[newest]);
+    if (idle > gap) {
+        span += idle - gap;
+    }
+
+    uint32_t wpm = (uint32_t)(wpm_keys_count - 1) * (60000 / 5) / (span ? span : 1);
+    current_wpm  = wpm > UINT8_MAX ? UINT8_MAX : wpm;
 }
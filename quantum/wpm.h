@@ -19,6 +19,21 @@
 
 #include "quantum.h"
 
+/* number of keystrokes the WPM is averaged over */
+#ifndef WPM_WINDOW_KEYS
+#    define WPM_WINDOW_KEYS 32
+#endif
+
+/* keystrokes older than this (ms) are ignored */
+#ifndef WPM_WINDOW_MS
+#    define WPM_WINDOW_MS 5000
+#endif
+
+/* how often (ms) the WPM is recomputed, and at most synced to the slave half */
+#ifndef WPM_UPDATE_INTERVAL
+#    define WPM_UPDATE_INTERVAL 100
+#endif
+
 bool wpm_keycode(uint16_t keycode);
 bool wpm_keycode_kb(uint16_t keycode);
 bool wpm_keycode_user(uint16_t keycode);
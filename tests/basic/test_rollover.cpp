@@ -0,0 +1,102 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+// Row 2 of the keymap holds KC_E to KC_K, seven keys for a six key report
+class Rollover : public TestFixture {};
+
+TEST_F(Rollover, SeventhKeyIsLeftOutOfTheReport) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    for (uint8_t col = 0; col < 6; col++) {
+        press_key(col, 2);
+        keyboard_task();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(6, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_F, KC_G, KC_H, KC_I, KC_J)));
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    for (uint8_t col = 0; col < 7; col++) {
+        release_key(col, 2);
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(7);
+    run_one_scan_loop();
+    idle_for(7);
+}
+
+TEST_F(Rollover, HeldKeyTakesTheSlotOfAReleasedOne) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(7);
+    for (uint8_t col = 0; col < 7; col++) {
+        press_key(col, 2);
+        keyboard_task();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(2, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_F, KC_H, KC_I, KC_J, KC_K)));
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // G is pressed again after K, so it waits for the next free slot
+    press_key(2, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_F, KC_H, KC_I, KC_J, KC_K)));
+    keyboard_task();
+    release_key(0, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_F, KC_G, KC_H, KC_I, KC_J, KC_K)));
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    for (uint8_t col = 1; col < 7; col++) {
+        release_key(col, 2);
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    idle_for(6);
+}
+
+TEST_F(Rollover, KeysAreReleasedInAnyOrder) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 2);
+    press_key(1, 2);
+    press_key(2, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_F)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_F, KC_G)));
+    idle_for(3);
+    release_key(1, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_G)));
+    keyboard_task();
+    press_key(1, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_F, KC_G)));
+    keyboard_task();
+    release_key(0, 2);
+    release_key(1, 2);
+    release_key(2, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_F, KC_G)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_G)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(3);
+}
@@ -95,3 +95,81 @@ TEST_F(Tapping, ANewTapWithinTappingTermIsBuggy) {
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).Times(1);
     idle_for(TAPPING_TERM);
 }
+
+TEST_F(Tapping, SlowScanTimesEventsWhenTheMatrixWasRead) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 20);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The release is read within the tapping term, by a scan that takes 30ms
+    // and only finishes after the tapping term
+    set_matrix_scan_duration(30);
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, SlowScanKeepsTheTimeOfQueuedEvents) {
+    TestDriver driver;
+    InSequence s;
+
+    // Every scan takes 10ms, so one task is 11ms
+    set_matrix_scan_duration(10);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(18);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Both releases are read 198ms after the tap key was pressed. Only one key is
+    // processed per task, so the tap key release waits for the next scan, but it
+    // keeps the time it was read at and is still a tap
+    release_key(0, 0);
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+}
+
+TEST_F(Tapping, SlowScanTimesNewChangesBehindQueuedEvents) {
+    TestDriver driver;
+    InSequence s;
+
+    // Every scan takes 10ms, so one task is 11ms
+    set_matrix_scan_duration(10);
+    press_key(0, 0);
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+
+    // The tap key is read by the next scan, while the B press still waits. It
+    // gets the time of that scan, not the one of the scan before
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    for (int i = 0; i < 17; i++) {
+        run_one_scan_loop();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Read 198ms after the tap key press, but 209ms after the A and B presses
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    run_one_scan_loop();
+
+    release_key(0, 0);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+}
@@ -0,0 +1,127 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+#include <vector>
+
+using testing::_;
+
+class Wpm : public TestFixture {
+   protected:
+    std::vector<uint16_t> presses;
+
+    // Let keystrokes left over from earlier tests fall out of the window. The timer
+    // restarts with every test suite, so those can look up to a window younger than they are
+    void forget_keystrokes(void) {
+        idle_for(2 * WPM_WINDOW_MS + WPM_UPDATE_INTERVAL);
+        EXPECT_EQ(get_current_wpm(), 0);
+    }
+
+    // Tap KC_A (0, 0) once every interval ms
+    void type(TestDriver& driver, int keys, uint16_t interval) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+        for (int i = 0; i < keys; i++) {
+            presses.push_back(timer_read());
+            press_key(0, 0);
+            run_one_scan_loop();
+            release_key(0, 0);
+            run_one_scan_loop();
+            idle_for(interval - 2);
+        }
+    }
+
+    // Floating point model of the typing rate over the keystrokes still in the window
+    double reference_wpm(void) {
+        uint16_t now = timer_read();
+        std::vector<uint16_t> window;
+        for (uint16_t t : presses) {
+            if ((uint16_t)(now - t) <= WPM_WINDOW_MS) window.push_back(t);
+        }
+        if (window.size() > WPM_WINDOW_KEYS) window.erase(window.begin(), window.end() - WPM_WINDOW_KEYS);
+        if (window.size() < 2) return 0;
+        double keys = window.size() - 1;
+        double span = (uint16_t)(window.back() - window.front());
+        return keys / 5 * 60000 / span;
+    }
+};
+
+TEST_F(Wpm, ConstantRateMatchesReference) {
+    TestDriver driver;
+    forget_keystrokes();
+
+    for (uint16_t wpm : {40, 60, 80, 100, 120, 150, 200}) {
+        presses.clear();
+        type(driver, 60, 60000 / 5 / wpm);
+        EXPECT_NEAR(reference_wpm(), wpm, 0.5);
+        EXPECT_NEAR(get_current_wpm(), reference_wpm(), 1) << "typing at " << wpm << " WPM";
+        forget_keystrokes();
+    }
+}
+
+TEST_F(Wpm, ChangesRateWithinWindow) {
+    TestDriver driver;
+    forget_keystrokes();
+
+    type(driver, 40, 200);
+    EXPECT_NEAR(get_current_wpm(), 60, 1);
+
+    // Once the slow keystrokes have left the window only the fast ones count
+    type(driver, WPM_WINDOW_KEYS + 1, 100);
+    EXPECT_NEAR(get_current_wpm(), 120, 1);
+}
+
+TEST_F(Wpm, DecaysToZeroAfterTyping) {
+    TestDriver driver;
+    forget_keystrokes();
+
+    type(driver, 20, 100);
+    uint8_t last = get_current_wpm();
+    EXPECT_NEAR(last, 120, 1);
+
+    for (int i = 0; i < WPM_WINDOW_MS / 500; i++) {
+        idle_for(500);
+        EXPECT_LE(get_current_wpm(), last);
+        last = get_current_wpm();
+    }
+    idle_for(WPM_UPDATE_INTERVAL);
+    EXPECT_EQ(get_current_wpm(), 0);
+}
+
+TEST_F(Wpm, ClampsToMaximum) {
+    TestDriver driver;
+    forget_keystrokes();
+
+    type(driver, 20, 10);
+    idle_for(WPM_UPDATE_INTERVAL);
+    EXPECT_EQ(get_current_wpm(), 255);
+}
+
+TEST_F(Wpm, IgnoresNonTypingKeys) {
+    TestDriver driver;
+    forget_keystrokes();
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    for (int i = 0; i < 20; i++) {
+        press_key(3, 0);  // KC_LSFT
+        run_one_scan_loop();
+        release_key(3, 0);
+        run_one_scan_loop();
+        idle_for(98);
+    }
+    idle_for(WPM_UPDATE_INTERVAL);
+    EXPECT_EQ(get_current_wpm(), 0);
+}
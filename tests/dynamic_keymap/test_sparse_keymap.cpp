@@ -0,0 +1,114 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <vector>
+
+// What VIA has room for in a reply after the position and count
+#define SPARSE_REPLY_SIZE 28
+
+#define KEY_COUNT (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS)
+
+class SparseKeymap : public TestFixture {
+   protected:
+    void SetUp() override { dynamic_keymap_reset(); }
+
+    // What a host does: ask for the keys from where the last reply stopped, and fill in the runs
+    std::vector<uint16_t> read_sparse(uint16_t reply_size = SPARSE_REPLY_SIZE) {
+        std::vector<uint16_t> keymap;
+        uint16_t              position = 0;
+        replies                        = 0;
+        while (position < KEY_COUNT) {
+            uint8_t data[SPARSE_REPLY_SIZE];
+            uint8_t count = dynamic_keymap_get_sparse(&position, reply_size, data);
+            EXPECT_GT(count, 0);
+            for (uint8_t i = 0; i < count; i++) {
+                uint8_t run = data[i * DYNAMIC_KEYMAP_SPARSE_ENTRY_SIZE];
+                keymap.insert(keymap.end(), run & DYNAMIC_KEYMAP_SPARSE_RUN_MAX, run & DYNAMIC_KEYMAP_SPARSE_KC_NO ? KC_NO : KC_TRNS);
+                keymap.push_back(data[i * DYNAMIC_KEYMAP_SPARSE_ENTRY_SIZE + 1] << 8 | data[i * DYNAMIC_KEYMAP_SPARSE_ENTRY_SIZE + 2]);
+            }
+            EXPECT_EQ(position, keymap.size());
+            replies++;
+        }
+        return keymap;
+    }
+
+    // The same keys with id_dynamic_keymap_get_buffer
+    std::vector<uint16_t> read_buffer() {
+        std::vector<uint8_t> buffer(dynamic_keymap_get_buffer_size());
+        for (uint16_t offset = 0; offset < buffer.size(); offset += SPARSE_REPLY_SIZE) {
+            dynamic_keymap_get_buffer(offset, std::min<uint16_t>(SPARSE_REPLY_SIZE, buffer.size() - offset), &buffer[offset]);
+        }
+        std::vector<uint16_t> keymap;
+        for (size_t i = 0; i < buffer.size(); i += 2) {
+            keymap.push_back(buffer[i] << 8 | buffer[i + 1]);
+        }
+        return keymap;
+    }
+
+    unsigned replies;
+};
+
+TEST_F(SparseKeymap, MatchesTheBuffer) {
+    std::vector<uint16_t> keymap = read_sparse();
+    EXPECT_EQ(keymap, read_buffer());
+    EXPECT_EQ(keymap[0], KC_ESC);
+    EXPECT_EQ(keymap[MATRIX_ROWS * MATRIX_COLS + 1], KC_MUTE);
+    // 72 requests with the buffer, most of these are for the base layer
+    EXPECT_LE(replies, 15u);
+}
+
+TEST_F(SparseKeymap, ResumesInTheMiddleOfARun) {
+    // Room for one entry per reply, so every run is read again
+    EXPECT_EQ(read_sparse(DYNAMIC_KEYMAP_SPARSE_ENTRY_SIZE + 2), read_buffer());
+}
+
+TEST_F(SparseKeymap, RunsOfDifferentKindsAreKeptApart) {
+    // KC_NO in the middle of a run of KC_TRNS, and a run of KC_NO up to a KC_TRNS
+    dynamic_keymap_set_keycode(3, 2, 5, KC_NO);
+    dynamic_keymap_set_keycode(3, 2, 6, KC_NO);
+    dynamic_keymap_set_keycode(4, 0, 0, KC_NO);
+    dynamic_keymap_set_keycode(4, 0, 1, KC_NO);
+    dynamic_keymap_set_keycode(7, MATRIX_ROWS - 1, MATRIX_COLS - 1, KC_B);
+    std::vector<uint16_t> keymap = read_sparse();
+    EXPECT_EQ(keymap, read_buffer());
+    EXPECT_EQ(keymap.back(), KC_B);
+}
+
+TEST_F(SparseKeymap, EmptyKeymap) {
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                dynamic_keymap_set_keycode(layer, row, col, KC_NO);
+            }
+        }
+    }
+    EXPECT_EQ(read_sparse(), std::vector<uint16_t>(KEY_COUNT, KC_NO));
+    // One entry per layer
+    EXPECT_EQ(replies, 1u);
+}
+
+TEST_F(SparseKeymap, KeysComeFromTheDynamicKeymap) {
+    TestDriver driver;
+    dynamic_keymap_set_keycode(0, 0, 0, KC_A);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
@@ -0,0 +1,59 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "scan_governor/scan_governor.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class IdleScanning : public TestFixture {
+   protected:
+    // Runs the scan loop until a scan reads the matrix change, which counts as activity
+    void wait_for_scan(void) {
+        for (int i = 0; i < 2 * SCAN_GOVERNOR_IDLE_INTERVAL && last_matrix_activity_elapsed() > 1; i++) {
+            run_one_scan_loop();
+        }
+        ASSERT_EQ(1u, last_matrix_activity_elapsed());
+    }
+};
+
+TEST_F(IdleScanning, DebouncedPressIsNotDelayed) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(100);
+    EXPECT_EQ(SCAN_GOVERNOR_IDLE_INTERVAL, scan_governor_interval());
+
+    // The governor would be back to long intervals well before the debounce
+    // time is up, but the scan rate stays up until the press gets through
+    press_key(0, 0);
+    wait_for_scan();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    idle_for(DEBOUNCE + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    wait_for_scan();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(DEBOUNCE + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
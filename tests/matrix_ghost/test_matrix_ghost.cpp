@@ -0,0 +1,123 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+
+class MatrixGhost : public TestFixture {
+   protected:
+    // Processes every pending change, one key per task
+    void run_tasks(int count = 4) {
+        for (int i = 0; i < count; i++) {
+            run_one_scan_loop();
+        }
+    }
+};
+
+TEST_F(MatrixGhost, RowSharingTwoColumnsIsIgnored) {
+    TestDriver driver;
+    press_key(0, 0);
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    run_tasks();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // F and G close a rectangle with A and B, so row 2 can't be told apart from a ghost
+    press_key(0, 2);
+    press_key(1, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_tasks();
+    release_key(0, 2);
+    release_key(1, 2);
+    run_tasks();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_tasks();
+}
+
+TEST_F(MatrixGhost, RowSharingOneColumnIsReported) {
+    TestDriver driver;
+    press_key(0, 0);
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    run_tasks();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(1, 2);
+    press_key(2, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_G)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_G, KC_H)));
+    run_tasks();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(4);
+    run_tasks();
+}
+
+TEST_F(MatrixGhost, BlanksDontMakeGhosts) {
+    TestDriver driver;
+    press_key(0, 0);
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_C)));
+    run_tasks();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Row 1 column 2 is KC_NO, so D is the only real key on its row
+    press_key(0, 1);
+    press_key(2, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_C, KC_D)));
+    run_tasks();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+    run_tasks();
+}
+
+TEST_F(MatrixGhost, GhostClearsWhenTheOtherRowIsReleased) {
+    TestDriver driver;
+    press_key(0, 0);
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    run_tasks();
+
+    press_key(0, 2);
+    press_key(1, 2);
+    run_tasks();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Only B is left sharing a column with row 2
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_F)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_F, KC_G)));
+    run_tasks();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    clear_all_keys();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+    run_tasks();
+}
@@ -0,0 +1,195 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class Suspend : public TestFixture {};
+
+TEST_F(Suspend, WakeKeyIsTyped) {
+    TestDriver driver;
+    driver.suspend();
+    press_key(0, 0);
+    EXPECT_TRUE(suspended_for(30));
+    // Released before the host is back
+    release_key(0, 0);
+    suspended_for(100);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    driver.resume();
+    run_one_scan_loop();
+}
+
+TEST_F(Suspend, NoWakeupWithoutKeys) {
+    TestDriver driver;
+    driver.suspend();
+    EXPECT_FALSE(suspended_for(1000));
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    driver.resume();
+    idle_for(10);
+}
+
+TEST_F(Suspend, KeysTypedWhileTheHostWakesUpAreKept) {
+    TestDriver driver;
+    driver.suspend();
+    press_key(0, 0);
+    EXPECT_TRUE(suspended_for(15));
+    release_key(0, 0);
+    suspended_for(15);
+    press_key(1, 0);
+    suspended_for(15);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    driver.resume();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Suspend, HeldKeysAreNotCleared) {
+    TestDriver driver;
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    driver.suspend();
+    suspended_for(100);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    driver.resume();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_C)));
+    run_one_scan_loop();
+}
+
+TEST_F(Suspend, KeyReleasedWhileSuspendedIsReleased) {
+    TestDriver driver;
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    driver.suspend();
+    release_key(1, 0);
+    suspended_for(100);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    driver.resume();
+    run_one_scan_loop();
+}
+
+TEST_F(Suspend, TapKeepsItsTiming) {
+    TestDriver driver;
+    driver.suspend();
+    // A mod-tap tapped just before the host takes longer than the tapping term to resume
+    press_key(1, 1);
+    suspended_for(30);
+    release_key(1, 1);
+    suspended_for(TAPPING_TERM * 2);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_D)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    driver.resume();
+    run_one_scan_loop();
+}
+
+TEST_F(Suspend, ChangesThatDontFitAreSeenAfterResume) {
+    TestDriver driver;
+    driver.suspend();
+    // Fills the buffer
+    press_key(0, 0);
+    suspended_for(15);
+    release_key(0, 0);
+    suspended_for(15);
+    press_key(1, 0);
+    suspended_for(15);
+    release_key(1, 0);
+    suspended_for(15);
+    // Still held when the host is back
+    press_key(2, 0);
+    suspended_for(15);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    driver.resume();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Suspend, OldTapIsNotTyped) {
+    TestDriver driver;
+    driver.suspend();
+    // Typed while the host couldn't be woken up, long before it resumes
+    press_key(0, 0);
+    suspended_for(30);
+    release_key(0, 0);
+    suspended_for(WAKE_KEY_TIMEOUT * 2);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    driver.resume();
+    idle_for(10);
+}
+
+TEST_F(Suspend, OldChangesLeaveTheKeysAsTheyEndedUp) {
+    TestDriver driver;
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    driver.suspend();
+    release_key(1, 0);
+    suspended_for(15);
+    press_key(0, 0);
+    suspended_for(15);
+    release_key(0, 0);
+    suspended_for(15);
+    press_key(2, 0);
+    suspended_for(WAKE_KEY_TIMEOUT * 2);
+
+    // The release of the key held before suspending still goes out, the tap doesn't
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    driver.resume();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
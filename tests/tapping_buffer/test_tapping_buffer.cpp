@@ -0,0 +1,89 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+namespace {
+// Keys from the test keymap that are cycled through when simulating a roll
+const struct {
+    uint8_t  col;
+    uint8_t  row;
+    uint16_t code;
+} roll_keys[] = {{0, 0, KC_A}, {1, 0, KC_B}, {0, 1, KC_C}, {1, 1, KC_D}};
+const unsigned roll_key_count = sizeof(roll_keys) / sizeof(roll_keys[0]);
+}  // namespace
+
+class TappingBuffer : public TestFixture {};
+
+TEST_F(TappingBuffer, RollOfSixteenKeysWithinTappingTermIsBuffered) {
+    TestDriver driver;
+    InSequence s;
+    uint16_t   overflows = action_tapping_get_overflow_count();
+
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    // 32 key events within the tapping term are all held back
+    for (unsigned i = 0; i < 16; i++) {
+        press_key(roll_keys[i % roll_key_count].col, roll_keys[i % roll_key_count].row);
+        run_one_scan_loop();
+        release_key(roll_keys[i % roll_key_count].col, roll_keys[i % roll_key_count].row);
+        run_one_scan_loop();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(action_tapping_get_overflow_count(), overflows);
+    EXPECT_GE(action_tapping_get_buffer_peak(), 32);
+
+    // The interrupted tap key resolves to its modifier on release
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Once the tapping term expires every buffered event is replayed in order
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    for (unsigned i = 0; i < 16; i++) {
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, roll_keys[i % roll_key_count].code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(TAPPING_TERM);
+    EXPECT_EQ(action_tapping_get_overflow_count(), overflows);
+}
+
+TEST_F(TappingBuffer, RollLongerThanWaitingBufferCountsOverflow) {
+    TestDriver driver;
+    uint16_t   overflows = action_tapping_get_overflow_count();
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(2, 0);
+    run_one_scan_loop();
+    for (unsigned i = 0; i < WAITING_BUFFER_SIZE / 2; i++) {
+        press_key(roll_keys[i % roll_key_count].col, roll_keys[i % roll_key_count].row);
+        run_one_scan_loop();
+        release_key(roll_keys[i % roll_key_count].col, roll_keys[i % roll_key_count].row);
+        run_one_scan_loop();
+    }
+    EXPECT_EQ(action_tapping_get_overflow_count(), overflows + 1);
+    EXPECT_EQ(action_tapping_get_buffer_peak(), WAITING_BUFFER_SIZE - 1);
+    release_key(2, 0);
+    run_one_scan_loop();
+}
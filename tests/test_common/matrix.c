@@ -17,20 +17,50 @@
 #include "matrix.h"
 #include "test_matrix.h"
 #include <string.h>
+#ifdef TEST_MATRIX_DEBOUNCE
+#    include "debounce.h"
+#endif
 
 static matrix_row_t matrix[MATRIX_ROWS] = {};
+static uint32_t     scan_duration       = 0;
+#ifdef TEST_MATRIX_DEBOUNCE
+// The pressed keys go through the debounce algorithm like a real matrix
+static matrix_row_t scanned[MATRIX_ROWS]   = {};
+static matrix_row_t debounced[MATRIX_ROWS] = {};
+#endif
+
+void advance_time(uint32_t ms);
 
 void matrix_init(void) {
     clear_all_keys();
+#ifdef TEST_MATRIX_DEBOUNCE
+    memset(scanned, 0, sizeof(scanned));
+    memset(debounced, 0, sizeof(debounced));
+    debounce_init(MATRIX_ROWS);
+#endif
     matrix_init_quantum();
 }
 
 uint8_t matrix_scan(void) {
+    // The keys are read at the start of the scan
+    advance_time(scan_duration);
+#ifdef TEST_MATRIX_DEBOUNCE
+    bool changed = memcmp(scanned, matrix, sizeof(matrix)) != 0;
+    memcpy(scanned, matrix, sizeof(matrix));
+    debounce(scanned, debounced, MATRIX_ROWS, changed);
+    matrix_scan_quantum();
+    return changed;
+#else
     matrix_scan_quantum();
     return 1;
+#endif
 }
 
+#ifdef TEST_MATRIX_DEBOUNCE
+matrix_row_t matrix_get_row(uint8_t row) { return debounced[row]; }
+#else
 matrix_row_t matrix_get_row(uint8_t row) { return matrix[row]; }
+#endif
 
 void matrix_print(void) {}
 
@@ -44,4 +74,6 @@ void release_key(uint8_t col, uint8_t row) { matrix[row] &= ~(1 << col); }
 
 void clear_all_keys(void) { memset(matrix, 0, sizeof(matrix)); }
 
+void set_matrix_scan_duration(uint32_t ms) { scan_duration = ms; }
+
 void led_set(uint8_t usb_led) {}
@@ -16,6 +16,10 @@
 
 #include "test_driver.hpp"
 
+extern "C" {
+#include "suspend.h"
+}
+
 TestDriver* TestDriver::m_this = nullptr;
 
 TestDriver::TestDriver() : m_driver{&TestDriver::keyboard_leds, &TestDriver::send_keyboard, &TestDriver::send_mouse, &TestDriver::send_system, &TestDriver::send_consumer} {
@@ -27,7 +31,19 @@ TestDriver::~TestDriver() { m_this = nullptr; }
 
 uint8_t TestDriver::keyboard_leds(void) { return m_this->m_leds; }
 
-void TestDriver::send_keyboard(report_keyboard_t* report) { m_this->send_keyboard_mock(*report); }
+void TestDriver::resume() {
+    m_suspended = false;
+    // What the protocol does when the USB wakeup event comes
+    suspend_wakeup_init();
+}
+
+void TestDriver::send_keyboard(report_keyboard_t* report) {
+    if (m_this->m_suspended) {
+        ADD_FAILURE() << "keyboard report sent while the host is suspended";
+        return;
+    }
+    m_this->send_keyboard_mock(*report);
+}
 
 void TestDriver::send_mouse(report_mouse_t* report) { m_this->send_mouse_mock(*report); }
 
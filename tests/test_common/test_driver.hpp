@@ -27,6 +27,10 @@ public:
     TestDriver();
     ~TestDriver();
     void set_leds(uint8_t leds) { m_leds = leds; }
+    // The host stops reading reports while it is suspended, one sent then would be lost and fails the test
+    void suspend() { m_suspended = true; }
+    // The host resumed, after a remote wakeup or by itself
+    void resume();
 
     MOCK_METHOD1(send_keyboard_mock, void (report_keyboard_t&));
     MOCK_METHOD1(send_mouse_mock, void (report_mouse_t&));
@@ -40,5 +44,6 @@ private:
     static void send_consumer(uint16_t data);
     host_driver_t m_driver;
     uint8_t m_leds = 0;
+    bool m_suspended = false;
     static TestDriver* m_this;
 };
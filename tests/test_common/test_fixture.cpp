@@ -8,6 +8,7 @@
 
 extern "C" {
 #include "action_layer.h"
+#include "suspend.h"
 }
 
 extern "C" {
@@ -36,6 +37,7 @@ TestFixture::~TestFixture() {
     EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
     layer_clear();
     clear_all_keys();
+    set_matrix_scan_duration(0);
     idle_for(TAPPING_TERM + 10);
     testing::Mock::VerifyAndClearExpectations(&driver);
     // Verify that the matrix really is cleared
@@ -53,3 +55,16 @@ void TestFixture::idle_for(unsigned time) {
         run_one_scan_loop();
     }
 }
+
+// How long suspend_power_down() sleeps on AVR
+#define SUSPEND_SCAN_INTERVAL 15
+
+bool TestFixture::suspended_for(unsigned ms) {
+    bool wakeup = false;
+    for (unsigned i = 0; i < ms; i += SUSPEND_SCAN_INTERVAL) {
+        suspend_power_down();
+        wakeup |= suspend_wakeup_condition();
+        advance_time(SUSPEND_SCAN_INTERVAL);
+    }
+    return wakeup;
+}
@@ -27,4 +27,6 @@ public:
 
     void run_one_scan_loop();
     void idle_for(unsigned ms);
+    // What the protocol's main loop does while the host is suspended, true if it asked the host to wake up
+    bool suspended_for(unsigned ms);
 };
@@ -23,6 +23,12 @@ extern "C" {
 void press_key(uint8_t col, uint8_t row);
 void release_key(uint8_t col, uint8_t row);
 void clear_all_keys(void);
+// Simulate a slow matrix, every matrix_scan() takes this long
+void set_matrix_scan_duration(uint32_t ms);
+
+// With TEST_MATRIX_DEBOUNCE defined, the pressed keys go through the debounce
+// algorithm, and matrix_scan() only reports a change when a key was pressed or
+// released since the last scan.
 
 #ifdef __cplusplus
 }
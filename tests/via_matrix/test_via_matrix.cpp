@@ -0,0 +1,101 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <vector>
+
+extern "C" {
+#include "raw_hid.h"
+#include "via.h"
+}
+
+static std::vector<uint8_t> reply;
+
+extern "C" void raw_hid_send(uint8_t *data, uint8_t length) { reply.assign(data, data + length); }
+
+class ViaMatrix : public TestFixture {
+   protected:
+    // Asks for a keyboard value and returns what follows the value id in the reply
+    std::vector<uint8_t> get_keyboard_value(uint8_t value_id) {
+        uint8_t data[32] = {id_get_keyboard_value, value_id};
+        reply.clear();
+        raw_hid_receive(data, sizeof(data));
+        EXPECT_EQ(sizeof(data), reply.size());
+        EXPECT_EQ(id_get_keyboard_value, reply[0]);
+        return std::vector<uint8_t>(reply.begin() + 2, reply.end());
+    }
+
+    // The changes as (row, col | 0x80 if pressed) pairs, after the count
+    std::vector<uint8_t> get_changes(void) {
+        std::vector<uint8_t> changes = get_keyboard_value(id_switch_matrix_changes);
+        uint8_t              count   = changes[0] & 0x7F;
+        changes.resize(1 + count * 2);
+        return changes;
+    }
+};
+
+TEST_F(ViaMatrix, ChangesSinceTheLastRequest) {
+    press_key(1, 0);
+    press_key(0, 1);
+    EXPECT_EQ(std::vector<uint8_t>({2, 0, 1 | 0x80, 1, 0 | 0x80}), get_changes());
+    EXPECT_EQ(std::vector<uint8_t>({0}), get_changes());
+
+    release_key(1, 0);
+    EXPECT_EQ(std::vector<uint8_t>({1, 0, 1}), get_changes());
+
+    release_key(0, 1);
+    press_key(7, 3);
+    EXPECT_EQ(std::vector<uint8_t>({2, 1, 0, 3, 7 | 0x80}), get_changes());
+    release_key(7, 3);
+    EXPECT_EQ(std::vector<uint8_t>({1, 3, 7}), get_changes());
+}
+
+TEST_F(ViaMatrix, StateRequestResetsTheChanges) {
+    press_key(2, 2);
+    get_keyboard_value(id_switch_matrix_state);
+    EXPECT_EQ(std::vector<uint8_t>({0}), get_changes());
+
+    release_key(2, 2);
+    EXPECT_EQ(std::vector<uint8_t>({1, 2, 2}), get_changes());
+}
+
+TEST_F(ViaMatrix, ChangesThatDontFitAreLeftForTheNextRequest) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            press_key(col, row);
+        }
+    }
+    // 14 pairs fit in a reply
+    std::vector<uint8_t> changes = get_keyboard_value(id_switch_matrix_changes);
+    EXPECT_EQ(14 | 0x80, changes[0]);
+    EXPECT_EQ(0, changes[1]);
+    EXPECT_EQ(0 | 0x80, changes[2]);
+    changes = get_keyboard_value(id_switch_matrix_changes);
+    EXPECT_EQ(14 | 0x80, changes[0]);
+    EXPECT_EQ(1, changes[1]);
+    EXPECT_EQ(6 | 0x80, changes[2]);
+    changes = get_keyboard_value(id_switch_matrix_changes);
+    EXPECT_EQ(4, changes[0]);
+    EXPECT_EQ(3, changes[1]);
+    EXPECT_EQ(4 | 0x80, changes[2]);
+    EXPECT_EQ(std::vector<uint8_t>({0}), get_changes());
+
+    clear_all_keys();
+    changes = get_keyboard_value(id_switch_matrix_changes);
+    EXPECT_EQ(14 | 0x80, changes[0]);
+    get_keyboard_value(id_switch_matrix_changes);
+    get_keyboard_value(id_switch_matrix_changes);
+}
@@ -12,6 +12,8 @@ TMK_COMMON_SRC +=	$(COMMON_DIR)/host.c \
 	$(COMMON_DIR)/sendchar_null.c \
 	$(COMMON_DIR)/eeconfig.c \
 	$(COMMON_DIR)/report.c \
+	$(COMMON_DIR)/report_queue.c \
+	$(COMMON_DIR)/report_scheduler.c \
 	$(PLATFORM_COMMON_DIR)/suspend.c \
 	$(PLATFORM_COMMON_DIR)/timer.c \
 	$(COMMON_DIR)/sync_timer.c \
@@ -75,6 +77,7 @@ endif
 
 ifeq ($(strip $(CONSOLE_ENABLE)), yes)
     TMK_COMMON_DEFS += -DCONSOLE_ENABLE
+    TMK_COMMON_SRC += $(COMMON_DIR)/console_buffer.c
 else
     TMK_COMMON_DEFS += -DNO_PRINT
     TMK_COMMON_DEFS += -DNO_DEBUG
@@ -103,6 +106,22 @@ ifeq ($(strip $(SLEEP_LED_ENABLE)), yes)
     TMK_COMMON_DEFS += -DNO_SUSPEND_POWER_DOWN
 endif
 
+ifeq ($(strip $(MATRIX_SCAN_THREAD_ENABLE)), yes)
+    ifneq ($(PLATFORM),CHIBIOS)
+        $(error MATRIX_SCAN_THREAD_ENABLE is only supported on ChibiOS)
+    endif
+    # A custom scan may share its bus or print to the console, neither of which
+    # is safe from the matrix thread
+    ifneq ($(strip $(CUSTOM_MATRIX)), no)
+        $(error MATRIX_SCAN_THREAD_ENABLE needs the built-in matrix)
+    endif
+    ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
+        $(error MATRIX_SCAN_THREAD_ENABLE is not supported on split keyboards)
+    endif
+    TMK_COMMON_SRC += $(COMMON_DIR)/matrix_thread.c
+    TMK_COMMON_DEFS += -DMATRIX_SCAN_THREAD_ENABLE
+endif
+
 ifeq ($(strip $(NO_SUSPEND_POWER_DOWN)), yes)
     TMK_COMMON_DEFS += -DNO_SUSPEND_POWER_DOWN
 endif
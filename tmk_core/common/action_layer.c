@@ -4,6 +4,10 @@
 #include "util.h"
 #include "action_layer.h"
 
+#ifdef TRACE_ENABLE
+#    include "trace.h"
+#endif
+
 #ifdef DEBUG_ACTION
 #    include "debug.h"
 #else
@@ -104,6 +108,9 @@ void layer_state_set(layer_state_t state) {
     layer_state = state;
     layer_debug();
     dprintln();
+#    ifdef TRACE_ENABLE
+    trace_event(TRACE_LAYER, get_highest_layer(state), state);
+#    endif
 #    ifdef STRICT_LAYER_RELEASE
     clear_keyboard_but_mods();  // To avoid stuck keys
 #    else
@@ -14,6 +14,12 @@
 
 #ifndef NO_ACTION_TAPPING
 
+#    if WAITING_BUFFER_SIZE < 2 || (WAITING_BUFFER_SIZE & (WAITING_BUFFER_SIZE - 1)) != 0 || WAITING_BUFFER_SIZE > 256
+#        error "WAITING_BUFFER_SIZE must be a power of two between 2 and 256"
+#    endif
+#    define WAITING_BUFFER_NEXT(i) (((i) + 1) & (WAITING_BUFFER_SIZE - 1))
+#    define WAITING_BUFFER_USED() ((uint8_t)(waiting_buffer_head - waiting_buffer_tail) & (WAITING_BUFFER_SIZE - 1))
+
 #    define IS_TAPPING() !IS_NOEVENT(tapping_key.event)
 #    define IS_TAPPING_PRESSED() (IS_TAPPING() && tapping_key.event.pressed)
 #    define IS_TAPPING_RELEASED() (IS_TAPPING() && !tapping_key.event.pressed)
@@ -39,6 +45,8 @@ static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t     waiting_buffer_head                 = 0;
 static uint8_t     waiting_buffer_tail                 = 0;
+static uint8_t     waiting_buffer_peak                 = 0;
+static uint16_t    waiting_buffer_overflows            = 0;
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
@@ -74,7 +82,7 @@ void action_tapping_process(keyrecord_t record) {
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail)) {
         if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
             debug("processed: waiting_buffer[");
             debug_dec(waiting_buffer_tail);
@@ -326,13 +334,15 @@ bool waiting_buffer_enq(keyrecord_t record) {
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
-        debug("waiting_buffer_enq: Over flow.\n");
+    if (WAITING_BUFFER_NEXT(waiting_buffer_head) == waiting_buffer_tail) {
+        if (waiting_buffer_overflows < UINT16_MAX) waiting_buffer_overflows++;
+        dprintf("waiting_buffer_enq: Over flow(%u).\n", waiting_buffer_overflows);
         return false;
     }
 
     waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_head                 = WAITING_BUFFER_NEXT(waiting_buffer_head);
+    if (WAITING_BUFFER_USED() > waiting_buffer_peak) waiting_buffer_peak = WAITING_BUFFER_USED();
 
     debug("waiting_buffer_enq: ");
     debug_waiting_buffer();
@@ -353,7 +363,7 @@ void waiting_buffer_clear(void) {
  * FIXME: Needs docs
  */
 bool waiting_buffer_typed(keyevent_t event) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
             return true;
         }
@@ -366,7 +376,7 @@ bool waiting_buffer_typed(keyevent_t event) {
  * FIXME: Needs docs
  */
 __attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (waiting_buffer[i].event.pressed) return true;
     }
     return false;
@@ -382,7 +392,7 @@ void waiting_buffer_scan_tap(void) {
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
 
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (IS_TAPPING_KEY(waiting_buffer[i].event.key) && !waiting_buffer[i].event.pressed && WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
             tapping_key.tap.count       = 1;
             waiting_buffer[i].tap.count = 1;
@@ -397,6 +407,18 @@ void waiting_buffer_scan_tap(void) {
     }
 }
 
+/** \brief Waiting buffer overflow count
+ *
+ * Number of key events lost because the waiting buffer was full, saturating at UINT16_MAX.
+ */
+uint16_t action_tapping_get_overflow_count(void) { return waiting_buffer_overflows; }
+
+/** \brief Waiting buffer peak
+ *
+ * Highest number of key events held in the waiting buffer at once.
+ */
+uint8_t action_tapping_get_buffer_peak(void) { return waiting_buffer_peak; }
+
 /** \brief Tapping key debug print
  *
  * FIXME: Needs docs
@@ -413,7 +435,7 @@ static void debug_tapping_key(void) {
  */
 static void debug_waiting_buffer(void) {
     debug("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         debug("[");
         debug_dec(i);
         debug("]=");
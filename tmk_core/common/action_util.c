@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_layer.h"
 #include "timer.h"
 #include "keycode_config.h"
+#include <string.h>
 
 extern keymap_config_t keymap_config;
 
@@ -28,23 +29,133 @@ static uint8_t real_mods  = 0;
 static uint8_t weak_mods  = 0;
 static uint8_t macro_mods = 0;
 
-#ifdef USB_6KRO_ENABLE
-#    define RO_ADD(a, b) ((a + b) % KEYBOARD_REPORT_KEYS)
-#    define RO_SUB(a, b) ((a - b + KEYBOARD_REPORT_KEYS) % KEYBOARD_REPORT_KEYS)
-#    define RO_INC(a) RO_ADD(a, 1)
-#    define RO_DEC(a) RO_SUB(a, 1)
-static int8_t cb_head  = 0;
-static int8_t cb_tail  = 0;
-static int8_t cb_count = 0;
-#endif
-
 // TODO: pointer variable is not needed
 // report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
 
-extern inline void add_key(uint8_t key);
-extern inline void del_key(uint8_t key);
-extern inline void clear_keys(void);
+/* Held keys, as a bitmap that the NKRO report is copied from and in the order
+ * they were pressed, which picks the keys of a 6KRO report. They are only
+ * copied into keyboard_report when it is sent. */
+#ifndef KEY_ORDER_SIZE
+#    define KEY_ORDER_SIZE 16
+#endif
+
+#define KEY_BIT(key) (1 << ((key)&7))
+
+static uint8_t key_bits[32];
+static uint8_t key_order[KEY_ORDER_SIZE];
+static uint8_t key_order_count = 0;
+static uint8_t key_count       = 0;
+static bool    keys_changed    = false;
+#ifdef NKRO_ENABLE
+static bool keys_nkro = false;
+#endif
+
+/* With more keys held than key_order holds, puts back the held keys it lost,
+ * lowest keycode first. Only happens with a lot of keys held. */
+static void refill_key_order(void) {
+    for (uint16_t key = 1; key < 256 && key_order_count < key_count && key_order_count < KEY_ORDER_SIZE; key++) {
+        if (!has_key(key) || memchr(key_order, key, key_order_count)) continue;
+        key_order[key_order_count++] = key;
+    }
+}
+
+/** \brief Add key
+ *
+ * Holds down a key in the next keyboard report.
+ */
+void add_key(uint8_t key) {
+    if (key == KC_NO || has_key(key)) return;
+
+    key_bits[key >> 3] |= KEY_BIT(key);
+    key_count++;
+    keys_changed = true;
+    if (key_order_count == KEY_ORDER_SIZE) {
+#ifdef USB_6KRO_ENABLE
+        // the newest keys win, forget the oldest
+        memmove(key_order, key_order + 1, KEY_ORDER_SIZE - 1);
+        key_order_count--;
+#else
+        return;
+#endif
+    }
+    key_order[key_order_count++] = key;
+}
+
+/** \brief Delete key
+ *
+ * Releases a key in the next keyboard report.
+ */
+void del_key(uint8_t key) {
+    if (!has_key(key)) return;
+
+    key_bits[key >> 3] &= ~KEY_BIT(key);
+    key_count--;
+    keys_changed = true;
+    uint8_t *order = memchr(key_order, key, key_order_count);
+    if (order) {
+        key_order_count--;
+        memmove(order, order + 1, key_order + key_order_count - order);
+    }
+    if (key_order_count < key_count) {
+        refill_key_order();
+    }
+}
+
+/** \brief Clear keys
+ *
+ * Releases all keys, but not the modifiers, in the next keyboard report.
+ */
+void clear_keys(void) {
+    memset(key_bits, 0, sizeof(key_bits));
+    key_order_count = 0;
+    key_count       = 0;
+    keys_changed    = true;
+}
+
+/** \brief Has key
+ *
+ * Whether the key is held, even if the report hasn't been sent yet.
+ */
+bool has_key(uint8_t key) { return key != KC_NO && (key_bits[key >> 3] & KEY_BIT(key)); }
+
+/** \brief Has any key
+ *
+ * Whether any key other than a modifier is held.
+ */
+bool has_any_key(void) { return key_count != 0; }
+
+/* Copies the held keys into keyboard_report */
+static void update_keyboard_report_keys(void) {
+#ifdef NKRO_ENABLE
+    bool nkro = keyboard_protocol && keymap_config.nkro;
+    if (nkro != keys_nkro) {
+        keys_nkro    = nkro;
+        keys_changed = true;
+    }
+#endif
+    if (!keys_changed) return;
+    keys_changed = false;
+
+#ifdef NKRO_ENABLE
+    if (nkro) {
+        uint8_t size = KEYBOARD_REPORT_BITS < sizeof(key_bits) ? KEYBOARD_REPORT_BITS : sizeof(key_bits);
+        memcpy(keyboard_report->nkro.bits, key_bits, size);
+        memset(keyboard_report->nkro.bits + size, 0, KEYBOARD_REPORT_BITS - size);
+        return;
+    }
+#endif
+    uint8_t count = key_order_count < KEYBOARD_REPORT_KEYS ? key_order_count : KEYBOARD_REPORT_KEYS;
+#ifdef USB_6KRO_ENABLE
+    // the newest keys win
+    const uint8_t *keys = key_order + key_order_count - count;
+#else
+    // the keys held first win, later ones go in as those are released
+    const uint8_t *keys = key_order;
+#endif
+    memcpy(keyboard_report->keys, keys, count);
+    memset(keyboard_report->keys + count, 0, KEYBOARD_REPORT_KEYS - count);
+}
 
 #ifndef NO_ACTION_ONESHOT
 static uint8_t oneshot_mods        = 0;
@@ -189,6 +300,7 @@ bool is_oneshot_layer_active(void) { return get_oneshot_layer_state(); }
  * FIXME: needs doc
  */
 void send_keyboard_report(void) {
+    update_keyboard_report_keys();
     keyboard_report->mods = real_mods;
     keyboard_report->mods |= weak_mods;
     keyboard_report->mods |= macro_mods;
@@ -32,3 +32,10 @@ typedef uint8_t pin_t;
 #define readPin(pin) ((bool)(PINx_ADDRESS(pin) & _BV((pin)&0xF)))
 
 #define togglePin(pin) (PORTx_ADDRESS(pin) ^= _BV((pin)&0xF))
+
+/* Whole-port access, for reading several pins of a port at once */
+typedef uint8_t port_data_t;
+
+#define getPinPort(pin) ((pin) >> PORT_SHIFTER)
+#define getPinPad(pin) ((pin)&0xF)
+#define readPort(pin) PINx_ADDRESS(pin)
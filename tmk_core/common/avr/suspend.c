@@ -3,6 +3,7 @@
 #include <avr/wdt.h>
 #include <avr/interrupt.h>
 #include "matrix.h"
+#include "keyboard.h"
 #include "action.h"
 #include "suspend.h"
 #include "timer.h"
@@ -167,12 +168,19 @@ __attribute__((weak)) void matrix_power_up(void) {}
 __attribute__((weak)) void matrix_power_down(void) {}
 bool                       suspend_wakeup_condition(void) {
     matrix_power_up();
+#ifdef WAKE_KEY_BUFFER_SIZE
+    // keep the key changes for once the host has resumed
+    bool wakeup = keyboard_suspended_scan();
+    matrix_power_down();
+    return wakeup;
+#else
     matrix_scan();
     matrix_power_down();
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
         if (matrix_get_row(r)) return true;
     }
     return false;
+#endif
 }
 
 /** \brief run user level code immediately after wakeup
@@ -192,8 +200,10 @@ __attribute__((weak)) void suspend_wakeup_init_kb(void) { suspend_wakeup_init_us
  * FIXME: needs doc
  */
 void suspend_wakeup_init(void) {
-    // clear keyboard state
+#ifndef WAKE_KEY_BUFFER_SIZE
+    // clear keyboard state, the keys stay as they are with the wake key buffer
     clear_keyboard();
+#endif
 
     // Turn on backlight
 #ifdef BACKLIGHT_ENABLE
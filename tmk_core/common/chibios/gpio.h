@@ -32,3 +32,10 @@ typedef ioline_t pin_t;
 #define readPin(pin) palReadLine(pin)
 
 #define togglePin(pin) palToggleLine(pin)
+
+/* Whole-port access, for reading several pins of a port at once */
+typedef ioportmask_t port_data_t;
+
+#define getPinPort(pin) PAL_PORT(pin)
+#define getPinPad(pin) PAL_PAD(pin)
+#define readPort(pin) palReadPort(PAL_PORT(pin))
@@ -4,6 +4,7 @@
 #include <hal.h>
 
 #include "matrix.h"
+#include "keyboard.h"
 #include "action.h"
 #include "action_util.h"
 #include "mousekey.h"
@@ -87,13 +88,28 @@ void suspend_power_down(void) {
 __attribute__((weak)) void matrix_power_up(void) {}
 __attribute__((weak)) void matrix_power_down(void) {}
 bool                       suspend_wakeup_condition(void) {
+#ifdef WAKE_KEY_BUFFER_SIZE
+    // keep the key changes for once the host has resumed
+#    ifndef MATRIX_SCAN_THREAD_ENABLE
+    matrix_power_up();
+#    endif
+    bool wakeup = keyboard_suspended_scan();
+#    ifndef MATRIX_SCAN_THREAD_ENABLE
+    matrix_power_down();
+#    endif
+    return wakeup;
+#else
+#    ifndef MATRIX_SCAN_THREAD_ENABLE
+    // the matrix thread keeps scanning while suspended otherwise
     matrix_power_up();
     matrix_scan();
     matrix_power_down();
+#    endif
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
         if (matrix_get_row(r)) return true;
     }
     return false;
+#endif
 }
 
 /** \brief run user level code immediately after wakeup
@@ -114,22 +130,26 @@ __attribute__((weak)) void suspend_wakeup_init_kb(void) { suspend_wakeup_init_us
  * FIXME: needs doc
  */
 void suspend_wakeup_init(void) {
+#ifndef WAKE_KEY_BUFFER_SIZE
     // clear keyboard state
     // need to do it manually, because we're running from ISR
     //  and clear_keyboard() calls print
     // so only clear the variables in memory
     // the reports will be sent from main.c afterwards
     // or if the PC asks for GET_REPORT
+    // (with the wake key buffer, the keys stay as they are and changes
+    // seen while suspended are processed next)
     clear_mods();
     clear_weak_mods();
     clear_keys();
-#ifdef MOUSEKEY_ENABLE
+#    ifdef MOUSEKEY_ENABLE
     mousekey_clear();
-#endif /* MOUSEKEY_ENABLE */
-#ifdef EXTRAKEY_ENABLE
+#    endif /* MOUSEKEY_ENABLE */
+#    ifdef EXTRAKEY_ENABLE
     host_system_send(0);
     host_consumer_send(0);
-#endif /* EXTRAKEY_ENABLE */
+#    endif /* EXTRAKEY_ENABLE */
+#endif
 #ifdef BACKLIGHT_ENABLE
     backlight_init();
 #endif /* BACKLIGHT_ENABLE */
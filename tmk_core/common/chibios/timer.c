@@ -31,12 +31,21 @@ uint32_t timer_read32(void) {
     //    - CH_CFG_ST_FREQUENCY = 10000, overflow will occur every ~6.5 seconds
     //    - CH_CFG_ST_FREQUENCY = 1000, overflow will occur every ~65 seconds
     // With this implementation, as long as we ensure a timer read happens at least once during the overflow period, timing should be accurate.
+#    ifdef MATRIX_SCAN_THREAD_ENABLE
+    // The matrix thread reads the timer too
+    syssts_t sts = chSysGetStatusAndLockX();
+    systime = (uint32_t)chVTGetSystemTimeX();
+#    endif
     if (systime < last_systime) {
         overflow += ((uint32_t)1) << CH_CFG_ST_RESOLUTION;
     }
 
-    last_systime = systime;
-    return (uint32_t)TIME_I2MS(systime - reset_point + overflow);
+    last_systime     = systime;
+    uint32_t elapsed = systime - reset_point + overflow;
+#    ifdef MATRIX_SCAN_THREAD_ENABLE
+    chSysRestoreStatusX(sts);
+#    endif
+    return (uint32_t)TIME_I2MS(elapsed);
 #else
     return (uint32_t)TIME_I2MS(systime - reset_point);
 #endif
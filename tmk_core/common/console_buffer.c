@@ -0,0 +1,85 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "console_buffer.h"
+
+/* "\n[65535 bytes dropped]\n" */
+#define DROPPED_NOTE_MAX 23
+
+static uint16_t buffer_index(const console_buffer_t *buffer, uint16_t n) {
+    uint16_t index = buffer->head + n;
+    return index >= CONSOLE_BUFFER_SIZE ? index - CONSOLE_BUFFER_SIZE : index;
+}
+
+static void put_byte(console_buffer_t *buffer, uint8_t c) {
+    buffer->data[buffer_index(buffer, buffer->count)] = c;
+    buffer->count++;
+}
+
+static void put_string(console_buffer_t *buffer, const char *s) {
+    while (*s) put_byte(buffer, *s++);
+}
+
+/* Tells the reader where output went missing, once there's room for it */
+static bool put_dropped_note(console_buffer_t *buffer) {
+    if (CONSOLE_BUFFER_SIZE - buffer->count < DROPPED_NOTE_MAX + 1) return false;
+
+    char  digits[6];
+    char *p = digits + sizeof(digits) - 1;
+    *p      = '\0';
+    uint16_t n = buffer->dropped;
+    do {
+        *--p = '0' + n % 10;
+        n /= 10;
+    } while (n);
+    put_string(buffer, "\n[");
+    put_string(buffer, p);
+    put_string(buffer, " bytes dropped]\n");
+    buffer->dropped = 0;
+    return true;
+}
+
+void console_buffer_init(console_buffer_t *buffer) { memset(buffer, 0, sizeof(console_buffer_t)); }
+
+bool console_buffer_put(console_buffer_t *buffer, uint8_t c) {
+    if ((buffer->dropped && !put_dropped_note(buffer)) || buffer->count == CONSOLE_BUFFER_SIZE) {
+        if (buffer->dropped < UINT16_MAX) buffer->dropped++;
+        return false;
+    }
+
+    put_byte(buffer, c);
+    return true;
+}
+
+uint16_t console_buffer_count(const console_buffer_t *buffer) { return buffer->count; }
+
+uint8_t console_buffer_peek(const console_buffer_t *buffer, uint8_t *data, uint8_t size) {
+    uint8_t count = buffer->count < size ? buffer->count : size;
+    // at most two pieces, before and after the end of the array
+    uint16_t first = CONSOLE_BUFFER_SIZE - buffer->head;
+    if (first > count) first = count;
+    memcpy(data, &buffer->data[buffer->head], first);
+    memcpy(data + first, buffer->data, count - first);
+    return count;
+}
+
+void console_buffer_skip(console_buffer_t *buffer, uint16_t count) {
+    if (count > buffer->count) count = buffer->count;
+    buffer->head = buffer_index(buffer, count);
+    buffer->count -= count;
+}
@@ -0,0 +1,69 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Console output waiting to go out over USB.
+ *
+ * sendchar() only appends to the buffer, the console task sends it on in whole
+ * packets when the endpoint is free. Output that doesn't fit is dropped and the
+ * number of bytes lost shows up in the output as soon as there's room again.
+ *
+ * The buffer does no locking. USB event handlers print from the USB interrupt,
+ * so the protocol code runs every call with interrupts masked.
+ */
+
+#ifndef CONSOLE_BUFFER_SIZE
+#    define CONSOLE_BUFFER_SIZE 128
+#endif
+
+/* ms a packet that isn't full waits for more output before it is sent */
+#ifndef CONSOLE_FLUSH_INTERVAL
+#    define CONSOLE_FLUSH_INTERVAL 10
+#endif
+
+#if CONSOLE_BUFFER_SIZE < 16 || CONSOLE_BUFFER_SIZE > 32767
+#    error "CONSOLE_BUFFER_SIZE must be between 16 and 32767"
+#endif
+
+typedef struct {
+    uint8_t  data[CONSOLE_BUFFER_SIZE];
+    uint16_t head;
+    uint16_t count;
+    /* bytes dropped since the last note about it */
+    uint16_t dropped;
+} console_buffer_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void console_buffer_init(console_buffer_t *buffer);
+/* false when the buffer is full and the byte was dropped */
+bool     console_buffer_put(console_buffer_t *buffer, uint8_t c);
+uint16_t console_buffer_count(const console_buffer_t *buffer);
+/* copies up to size of the oldest bytes to data, without taking them off the buffer */
+uint8_t console_buffer_peek(const console_buffer_t *buffer, uint8_t *data, uint8_t size);
+/* takes count bytes off the buffer, after they have been sent */
+void console_buffer_skip(console_buffer_t *buffer, uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
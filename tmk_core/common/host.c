@@ -22,6 +22,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "debug.h"
 
+#ifdef TRACE_ENABLE
+#    include "trace.h"
+#endif
+
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
 extern keymap_config_t keymap_config;
@@ -63,6 +67,9 @@ void host_keyboard_send(report_keyboard_t *report) {
 #endif
     }
     (*driver->send_keyboard)(report);
+#ifdef TRACE_ENABLE
+    trace_event(TRACE_REPORT, report->mods, has_anykey(report));
+#endif
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -31,6 +31,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#if defined(DEBOUNCE_TRACKS_CHANGES) || defined(SCAN_GOVERNOR_ENABLE)
+#    include "debounce.h"
+#endif
+#ifdef MATRIX_SCAN_THREAD_ENABLE
+#    include "matrix_thread.h"
+#endif
+#ifdef SCAN_GOVERNOR_ENABLE
+#    include "scan_governor/scan_governor.h"
+#    include "suspend.h"
+#endif
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -96,6 +106,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef DIP_SWITCH_ENABLE
 #    include "dip_switch.h"
 #endif
+#ifdef TRACE_ENABLE
+#    include "trace.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) { return last_input_modification_time; }
@@ -123,7 +136,11 @@ void matrix_scan_perf_task(void) {
     uint32_t timer_now = timer_read32();
     if (TIMER_DIFF_32(timer_now, matrix_timer) > 1000) {
 #    if defined(CONSOLE_ENABLE)
+#        ifdef SCAN_GOVERNOR_ENABLE
+        dprintf("matrix scan frequency: %lu, interval: %u ms\n", matrix_scan_count, scan_governor_interval());
+#        else
         dprintf("matrix scan frequency: %lu\n", matrix_scan_count);
+#        endif
 #    endif
         last_matrix_scan_count = matrix_scan_count;
         matrix_timer           = timer_now;
@@ -138,16 +155,50 @@ uint32_t get_matrix_scan_rate(void) { return last_matrix_scan_count; }
 
 #ifdef MATRIX_HAS_GHOST
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
-static matrix_row_t   get_real_keys(uint8_t row, matrix_row_t rowdata) {
-    matrix_row_t out = 0;
-    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-        // read each key in the row data and check if the keymap defines it as a real key
-        if (pgm_read_byte(&keymaps[0][row][col]) && (rowdata & (1 << col))) {
-            // this creates new row data, if a key is defined in the keymap, it will be set here
-            out |= 1 << col;
+
+// Keys the keymap defines on the base layer, blanks in the matrix can't be pressed
+static matrix_row_t real_keys_mask[MATRIX_ROWS];
+// Real keys down on each row, as of the last ghost_update()
+static matrix_row_t real_keys[MATRIX_ROWS];
+// How many rows have a real key down on each column
+static uint8_t col_rows[MATRIX_COLS];
+// Columns with a real key down on at least one row, and on at least two rows
+static matrix_row_t cols_once  = 0;
+static matrix_row_t cols_twice = 0;
+
+static void ghost_init(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        real_keys_mask[row] = 0;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (pgm_read_word(&keymaps[0][row][col])) {
+                real_keys_mask[row] |= MATRIX_ROW_SHIFTER << col;
+            }
+        }
+    }
+}
+
+/* Brings the real keys and column counts up to date with the matrix.
+ * Only the keys that changed since the last update are counted again.
+ */
+static void ghost_update(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t keys   = matrix_get_row(row) & real_keys_mask[row];
+        matrix_row_t change = keys ^ real_keys[row];
+        if (!change) continue;
+
+        real_keys[row] = keys;
+        for (; change; change &= change - 1) {
+            uint8_t      col      = MATRIX_ROW_FIRST_COL(change);
+            matrix_row_t col_mask = MATRIX_ROW_SHIFTER << col;
+            if (keys & col_mask) {
+                col_rows[col]++;
+            } else {
+                col_rows[col]--;
+            }
+            cols_once  = col_rows[col] >= 1 ? cols_once | col_mask : cols_once & ~col_mask;
+            cols_twice = col_rows[col] >= 2 ? cols_twice | col_mask : cols_twice & ~col_mask;
         }
     }
-    return out;
 }
 
 static inline bool popcount_more_than_one(matrix_row_t rowdata) {
@@ -155,12 +206,13 @@ static inline bool popcount_more_than_one(matrix_row_t rowdata) {
     return rowdata;
 }
 
+/* Call ghost_update() first. */
 static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
     /* No ghost exists when less than 2 keys are down on the row.
     If there are "active" blanks in the matrix, the key can't be pressed by the user,
     there is no doubt as to which keys are really being pressed.
     The ghosts will be ignored, they are KC_NO.   */
-    rowdata = get_real_keys(row, rowdata);
+    rowdata &= real_keys_mask[row];
     if ((popcount_more_than_one(rowdata)) == 0) {
         return false;
     }
@@ -170,9 +222,15 @@ static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
     If there are two or more real keys pressed and they match columns with
     at least two of another row's real keys, the row will be ignored. Keep in mind,
     we are checking one row at a time, not all of them at once.
+    A ghost needs two of the row's columns to have real keys down on other rows,
+    which the column counts tell without looking at the other rows.
     */
+    matrix_row_t shared = rowdata & (cols_twice | (cols_once & ~real_keys[row]));
+    if (!popcount_more_than_one(shared)) {
+        return false;
+    }
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-        if (i != row && popcount_more_than_one(get_real_keys(i, matrix_get_row(i)) & rowdata)) {
+        if (i != row && popcount_more_than_one(real_keys[i] & rowdata)) {
             return true;
         }
     }
@@ -278,6 +336,9 @@ void keyboard_init(void) {
     timer_init();
     sync_timer_init();
     matrix_init();
+#ifdef MATRIX_HAS_GHOST
+    ghost_init();
+#endif
 #ifdef VIA_ENABLE
     via_init();
 #endif
@@ -342,82 +403,335 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
 #endif
 }
 
-/** \brief Keyboard task: Do keyboard routine jobs
- *
- * Do routine keyboard jobs:
+#ifdef MATRIX_SCAN_THREAD_ENABLE
+/** \brief Matrix task: Process the key events queued by the matrix thread
  *
- * * scan matrix
- * * handle mouse movements
- * * run visualizer code
- * * handle midi commands
- * * light LEDs
+ * The matrix thread scans and debounces, only the scan hooks run here.
+ * Returns true if there were any events.
+ */
+static bool matrix_task(void) {
+    keyevent_t event;
+    bool       matrix_changed = false;
+#    ifdef QMK_KEYS_PER_SCAN
+    uint8_t keys_processed = 0;
+#    endif
+
+    matrix_scan_quantum();
+    matrix_scan_perf_task();
+
+    while (matrix_thread_get_event(&event)) {
+        if (debug_matrix) matrix_print();
+#    ifdef TRACE_ENABLE
+        trace_event(TRACE_MATRIX, event.pressed, event.key.row << 8 | event.key.col);
+#    endif
+        if (should_process_keypress()) {
+            action_exec(event);
+        }
+        switch_events(event.key.row, event.key.col, event.pressed);
+        matrix_changed = true;
+
+#    ifdef QMK_KEYS_PER_SCAN
+        // only jump out if we have processed "enough" keys.
+        if (++keys_processed >= QMK_KEYS_PER_SCAN) break;
+#    endif
+    }
+
+    // call with pseudo tick event when no real key event.
+    if (!matrix_changed) action_exec(TICK);
+    return matrix_changed;
+}
+#else
+// The keys processed so far
+static matrix_row_t matrix_prev[MATRIX_ROWS];
+#    ifdef DEBOUNCE_TRACKS_CHANGES
+// matrix_prev may still differ from the debounced matrix
+static bool matrix_pending = true;
+#    endif
+
+/** \brief Matrix task: Scan the matrix and process the changes
  *
- * This is repeatedly called as fast as possible.
+ * Returns true if the raw matrix changed.
  */
-void keyboard_task(void) {
-    static matrix_row_t matrix_prev[MATRIX_ROWS];
-    static uint8_t      led_status    = 0;
-    matrix_row_t        matrix_row    = 0;
-    matrix_row_t        matrix_change = 0;
-#ifdef QMK_KEYS_PER_SCAN
+static bool matrix_task(void) {
+    matrix_row_t matrix_row    = 0;
+    matrix_row_t matrix_change = 0;
+#    ifdef QMK_KEYS_PER_SCAN
     uint8_t keys_processed = 0;
-#endif
-#ifdef ENCODER_ENABLE
-    bool encoders_changed = false;
-#endif
+#    endif
+    // Changes left for a later task keep the time of the scan that saw them
+    static uint16_t event_time  = 0;
+    static bool     events_left = false;
+    // The matrix as of event_time, and when a later scan first changed it, 0 if none has
+    static matrix_row_t matrix_seen[MATRIX_ROWS];
+    static uint16_t     newer_time = 0;
+    bool                backlog    = events_left;
+
+#    ifdef SCAN_GOVERNOR_ENABLE
+    // Held keys and changes still being debounced keep the full scan rate, so
+    // neither is delayed
+    bool active = events_left || debounce_active();
+    for (uint8_t r = 0; r < MATRIX_ROWS && !active; r++) {
+        active = matrix_prev[r];
+    }
+    if (!scan_governor_task(active)) {
+        matrix_scan_quantum();
+        action_exec(TICK);
+        // Idle the MCU instead of spinning until the next scan: AVR sleeps until
+        // the next interrupt, at most a timer tick, ChibiOS until the scan is due
+        suspend_idle(scan_governor_time_to_scan());
+        return false;
+    }
+#    endif
 
-    housekeeping_task_kb();
-    housekeeping_task_user();
+    uint16_t scan_time      = timer_read() | 1; /* time should not be 0 */
+    uint8_t  matrix_changed = matrix_scan();
+    matrix_scan_perf_task();
+    if (!backlog) {
+        event_time = scan_time;
+    } else if (!newer_time) {
+        for (uint8_t r = 0; r < MATRIX_ROWS && !newer_time; r++) {
+            if (matrix_get_row(r) != matrix_seen[r]) newer_time = scan_time;
+        }
+    }
 
-    uint8_t matrix_changed = matrix_scan();
-    if (matrix_changed) last_matrix_activity_trigger();
+#    ifdef DEBOUNCE_TRACKS_CHANGES
+    // The debounced matrix only changes when the raw matrix did, or when the
+    // debouncer still had changes pending, so there is nothing to compare otherwise
+    if (!matrix_changed && !matrix_pending) goto MATRIX_LOOP_DONE;
+    matrix_pending = true;
+#    endif
 
+#    ifdef MATRIX_HAS_GHOST
+    ghost_update();
+#    endif
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
         matrix_row    = matrix_get_row(r);
         matrix_change = matrix_row ^ matrix_prev[r];
         if (matrix_change) {
-#ifdef MATRIX_HAS_GHOST
+#    ifdef MATRIX_HAS_GHOST
             if (has_ghost_in_row(r, matrix_row)) {
                 continue;
             }
-#endif
+#    endif
             if (debug_matrix) matrix_print();
-            matrix_row_t col_mask = 1;
-            for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
-                if (matrix_change & col_mask) {
-                    if (should_process_keypress()) {
-                        action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
-                        });
-                    }
-                    // record a processed key
-                    matrix_prev[r] ^= col_mask;
+            // only visit the changed keys, lowest column first
+            for (; matrix_change; matrix_change &= matrix_change - 1) {
+                uint8_t      c        = MATRIX_ROW_FIRST_COL(matrix_change);
+                matrix_row_t col_mask = MATRIX_ROW_SHIFTER << c;
+#    ifdef TRACE_ENABLE
+                trace_event(TRACE_MATRIX, (matrix_row & col_mask) != 0, r << 8 | c);
+#    endif
+                if (should_process_keypress()) {
+                    // a key that changed again since event_time was read by a later scan
+                    bool newer = backlog && ((matrix_row ^ matrix_seen[r]) & col_mask);
+                    action_exec((keyevent_t){
+                        .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = newer ? newer_time : event_time
+                    });
+                }
+                // record a processed key
+                matrix_prev[r] ^= col_mask;
 
-                    switch_events(r, c, (matrix_row & col_mask));
+                switch_events(r, c, (matrix_row & col_mask));
 
-#ifdef QMK_KEYS_PER_SCAN
-                    // only jump out if we have processed "enough" keys.
-                    if (++keys_processed >= QMK_KEYS_PER_SCAN)
-#endif
-                        // process a key per task call
-                        goto MATRIX_LOOP_END;
+#    ifdef QMK_KEYS_PER_SCAN
+                // only jump out if we have processed "enough" keys.
+                if (++keys_processed >= QMK_KEYS_PER_SCAN)
+#    endif
+                {
+                    // earlier rows are done, or ghosted and skipped anyway
+                    bool seen_left = false;
+                    events_left    = false;
+                    for (uint8_t i = r; i < MATRIX_ROWS; i++) {
+                        matrix_row_t left = matrix_get_row(i) ^ matrix_prev[i];
+                        events_left |= left != 0;
+                        seen_left |= (left & ~(matrix_get_row(i) ^ matrix_seen[i])) != 0;
+                    }
+                    // the changes of this scan start a backlog, or those of a later scan take over
+                    if (events_left && (!backlog || !seen_left)) {
+                        if (backlog && newer_time) event_time = newer_time;
+                        for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+                            matrix_seen[i] = matrix_get_row(i);
+                        }
+                        newer_time = 0;
+                    }
+                    // process a key per task call
+                    return matrix_changed;
                 }
             }
         }
     }
+    events_left = false;
+
+#    ifdef DEBOUNCE_TRACKS_CHANGES
+MATRIX_LOOP_DONE:
+    matrix_pending = debounce_active();
+#    endif
     // call with pseudo tick event when no real key event.
-#ifdef QMK_KEYS_PER_SCAN
+#    ifdef QMK_KEYS_PER_SCAN
     // we can get here with some keys processed now.
     if (!keys_processed)
-#endif
+#    endif
         action_exec(TICK);
 
-MATRIX_LOOP_END:
+    return matrix_changed;
+}
+#endif
 
-#ifdef DEBUG_MATRIX_SCAN_RATE
-    matrix_scan_perf_task();
+#ifdef WAKE_KEY_BUFFER_SIZE
+#    ifndef WAKE_KEY_TIMEOUT
+#        define WAKE_KEY_TIMEOUT 1000
+#    endif
+// event times are 16-bit
+#    if WAKE_KEY_TIMEOUT > 60000
+#        error "WAKE_KEY_TIMEOUT can't be greater than 60000"
+#    endif
+
+// Key changes seen while the host was suspended
+static keyevent_t wake_keys[WAKE_KEY_BUFFER_SIZE];
+static uint8_t    wake_key_count = 0;
+// When the oldest of them was seen
+static uint32_t wake_keys_timer;
+
+/** \brief Forget key changes kept for longer than WAKE_KEY_TIMEOUT
+ *
+ * A host that doesn't allow remote wakeup, or takes too long to resume, would
+ * otherwise get keys typed long before. Dropping the changes outright could
+ * lose the release of a key held before the host suspended, so the keys that
+ * ended up changed keep their last change, timed now.
+ */
+static void wake_keys_expire(void) {
+    if (!wake_key_count || timer_elapsed32(wake_keys_timer) <= WAKE_KEY_TIMEOUT) {
+        return;
+    }
+
+    uint16_t now  = timer_read() | 1;
+    uint8_t  kept = 0;
+    for (uint8_t i = 0; i < wake_key_count; i++) {
+        keyevent_t event = wake_keys[i];
+        bool       keep  = true;
+        bool       first = true;
+        for (uint8_t j = 0; j < wake_key_count && keep; j++) {
+            if (j == i || !KEYEQ(wake_keys[j].key, event.key)) continue;
+            // not the last change of the key, or the key ended up as it was
+            if (j > i || (first && wake_keys[j].pressed != event.pressed)) keep = false;
+            first = false;
+        }
+        if (keep) {
+            event.time        = now;
+            wake_keys[kept++] = event;
+        }
+    }
+    wake_key_count  = kept;
+    wake_keys_timer = timer_read32();
+}
+
+/** \brief Scan the matrix while the host is suspended
+ *
+ * The protocol calls this at the suspended rate instead of keyboard_task(). Key
+ * changes are kept until keyboard_task() runs again once the host has resumed,
+ * so the keys that woke it up are typed. Changes that don't fit are left for
+ * keyboard_task() to see in the matrix.
+ *
+ * Returns true while a key is pressed, to wake the host up.
+ */
+bool keyboard_suspended_scan(void) {
+    wake_keys_expire();
+    if (!wake_key_count) wake_keys_timer = timer_read32();
+
+#    ifdef MATRIX_SCAN_THREAD_ENABLE
+    // The matrix thread keeps scanning, the events wait in its queue when there is no room here
+    while (wake_key_count < WAKE_KEY_BUFFER_SIZE && matrix_thread_get_event(&wake_keys[wake_key_count])) {
+        wake_key_count++;
+    }
+#    else
+    uint16_t scan_time = timer_read() | 1;
+    matrix_scan();
+#        ifdef DEBOUNCE_TRACKS_CHANGES
+    matrix_pending = true;
+#        endif
+#        ifdef MATRIX_HAS_GHOST
+    ghost_update();
+#        endif
+    for (uint8_t r = 0; r < MATRIX_ROWS && wake_key_count < WAKE_KEY_BUFFER_SIZE; r++) {
+        matrix_row_t matrix_row    = matrix_get_row(r);
+        matrix_row_t matrix_change = matrix_row ^ matrix_prev[r];
+#        ifdef MATRIX_HAS_GHOST
+        if (matrix_change && has_ghost_in_row(r, matrix_row)) {
+            continue;
+        }
+#        endif
+        for (; matrix_change && wake_key_count < WAKE_KEY_BUFFER_SIZE; matrix_change &= matrix_change - 1) {
+            uint8_t      c        = MATRIX_ROW_FIRST_COL(matrix_change);
+            matrix_row_t col_mask = MATRIX_ROW_SHIFTER << c;
+
+            wake_keys[wake_key_count++] = (keyevent_t){.key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = scan_time};
+            matrix_prev[r] ^= col_mask;
+        }
+    }
+#    endif
+
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        if (matrix_get_row(r)) return true;
+    }
+    return false;
+}
+
+/** \brief Process the key changes seen while the host was suspended
+ *
+ * They keep the time they were seen at, so a tap stays a tap, unless they are
+ * older than WAKE_KEY_TIMEOUT.
+ * Returns true if there were any.
+ */
+static bool wake_keys_task(void) {
+    wake_keys_expire();
+    if (!wake_key_count) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < wake_key_count; i++) {
+        keyevent_t event = wake_keys[i];
+#    ifdef TRACE_ENABLE
+        trace_event(TRACE_MATRIX, event.pressed, event.key.row << 8 | event.key.col);
+#    endif
+        if (should_process_keypress()) {
+            action_exec(event);
+        }
+        switch_events(event.key.row, event.key.col, event.pressed);
+    }
+    wake_key_count = 0;
+    return true;
+}
+#endif
+
+/** \brief Keyboard task: Do keyboard routine jobs
+ *
+ * Do routine keyboard jobs:
+ *
+ * * scan matrix
+ * * handle mouse movements
+ * * run visualizer code
+ * * handle midi commands
+ * * light LEDs
+ *
+ * This is repeatedly called as fast as possible.
+ */
+void keyboard_task(void) {
+    static uint8_t led_status = 0;
+#ifdef ENCODER_ENABLE
+    bool encoders_changed = false;
 #endif
 
+    housekeeping_task_kb();
+    housekeeping_task_user();
+
+#ifdef WAKE_KEY_BUFFER_SIZE
+    bool matrix_changed = wake_keys_task();
+    matrix_changed |= matrix_task();
+#else
+    bool matrix_changed = matrix_task();
+#endif
+    if (matrix_changed) last_matrix_activity_trigger();
+
 #if defined(RGBLIGHT_ENABLE)
     rgblight_task();
 #endif
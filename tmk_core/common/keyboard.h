@@ -30,7 +30,14 @@ typedef struct {
     uint8_t row;
 } keypos_t;
 
-/* key event */
+/* key event
+ *
+ * time is timer_read() when the matrix scan that saw the change started. It
+ * stays a 16-bit millisecond value: keymaps compare it with timer_read(), most
+ * platform timers only count milliseconds, and every event held in the tapping
+ * and combo buffers would grow by a microsecond field. Where that resolution
+ * is wanted, TRACE_ENABLE logs each processed change in microseconds.
+ */
 typedef struct {
     keypos_t key;
     bool     pressed;
@@ -58,6 +65,10 @@ void keyboard_setup(void);
 void keyboard_init(void);
 /* it runs repeatedly in main loop */
 void keyboard_task(void);
+#ifdef WAKE_KEY_BUFFER_SIZE
+/* it runs in place of keyboard_task while the host is suspended, true when it should be woken up */
+bool keyboard_suspended_scan(void);
+#endif
 /* it runs when host LED status is updated */
 void keyboard_set_leds(uint8_t leds);
 /* it runs whenever code has to behave differently on a slave */
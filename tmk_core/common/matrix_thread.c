@@ -0,0 +1,112 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Matrix scanning in its own thread.
+
+matrix_thread_task() reads and debounces the matrix and queues every change as a key event,
+stamped with the time of the scan that saw it. keyboard_task() pops the events on the main thread.
+The queue has one producer and one consumer: the head is only written by the matrix thread and
+the tail only by the main thread, so it needs no lock.
+
+Besides the queue, the main thread only reads the debounced matrix, a row at a time, which is a
+single load. Custom matrices are rejected at build time as their scan code may use a shared bus or
+the console.
+*/
+
+#include "matrix_thread.h"
+#include "matrix.h"
+#include "timer.h"
+#ifdef DEBOUNCE_TRACKS_CHANGES
+#    include "debounce.h"
+#endif
+
+#ifdef MATRIX_HAS_GHOST
+#    error "MATRIX_SCAN_THREAD_ENABLE does not support MATRIX_HAS_GHOST"
+#endif
+
+#ifndef MATRIX_THREAD_QUEUE_SIZE
+#    define MATRIX_THREAD_QUEUE_SIZE 32
+#endif
+
+#if MATRIX_THREAD_QUEUE_SIZE > 128 || (MATRIX_THREAD_QUEUE_SIZE & (MATRIX_THREAD_QUEUE_SIZE - 1))
+#    error "MATRIX_THREAD_QUEUE_SIZE must be a power of two, no more than 128"
+#endif
+
+static keyevent_t queue[MATRIX_THREAD_QUEUE_SIZE];
+// Free running indices, the queue holds head - tail events
+static uint8_t queue_head = 0;
+static uint8_t queue_tail = 0;
+
+// The matrix as seen by the main thread once it has popped every queued event
+static matrix_row_t matrix_prev[MATRIX_ROWS];
+
+static bool queue_push(keyevent_t event) {
+    uint8_t head = queue_head;
+    if ((uint8_t)(head - __atomic_load_n(&queue_tail, __ATOMIC_ACQUIRE)) == MATRIX_THREAD_QUEUE_SIZE) {
+        return false;
+    }
+    queue[head % MATRIX_THREAD_QUEUE_SIZE] = event;
+    __atomic_store_n(&queue_head, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+bool matrix_thread_get_event(keyevent_t *event) {
+    uint8_t tail = queue_tail;
+    if (tail == __atomic_load_n(&queue_head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *event = queue[tail % MATRIX_THREAD_QUEUE_SIZE];
+    __atomic_store_n(&queue_tail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+void matrix_thread_task(void) {
+#ifdef DEBOUNCE_TRACKS_CHANGES
+    // matrix_prev may still differ from the debounced matrix
+    static bool matrix_pending = true;
+#endif
+
+    uint16_t scan_time      = timer_read() | 1; /* time should not be 0 */
+    bool     matrix_changed = matrix_scan_keys();
+
+#ifdef DEBOUNCE_TRACKS_CHANGES
+    if (!matrix_changed && !matrix_pending) return;
+    matrix_pending = debounce_active();
+#else
+    (void)matrix_changed;
+#endif
+
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        matrix_row_t matrix_row    = matrix_get_row(r);
+        matrix_row_t matrix_change = matrix_row ^ matrix_prev[r];
+        if (!matrix_change) continue;
+
+        for (; matrix_change; matrix_change &= matrix_change - 1) {
+            uint8_t      c        = MATRIX_ROW_FIRST_COL(matrix_change);
+            matrix_row_t col_mask = MATRIX_ROW_SHIFTER << c;
+            if (!queue_push((keyevent_t){.key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = scan_time})) {
+                // Queue full: the rest is queued by a later scan
+#ifdef DEBOUNCE_TRACKS_CHANGES
+                matrix_pending = true;
+#endif
+                return;
+            }
+            matrix_prev[r] ^= col_mask;
+        }
+    }
+}
@@ -0,0 +1,28 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include "keyboard.h"
+
+/* Scan and debounce the matrix and queue its changes. Called by the matrix thread only. */
+void matrix_thread_task(void);
+/* Pop the oldest queued change. Called by the main thread only. */
+bool matrix_thread_get_event(keyevent_t *event);
+/* Start the matrix thread, after keyboard_init(). Provided by the platform. */
+void matrix_thread_start(void);
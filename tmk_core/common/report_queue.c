@@ -0,0 +1,135 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "report_queue.h"
+
+/* slot of the nth queued report */
+static uint8_t queue_index(const report_queue_t *queue, uint8_t n) {
+    uint8_t index = queue->sent + 1 + n;
+    return index > REPORT_QUEUE_SIZE ? index - (REPORT_QUEUE_SIZE + 1) : index;
+}
+
+static bool report_equal(const report_keyboard_t *a, const report_keyboard_t *b) { return !memcmp(a, b, sizeof(report_keyboard_t)); }
+
+static bool report_has_key(const report_keyboard_t *report, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] == key) return true;
+    }
+    return false;
+}
+
+/* whether to holds a key or modifier that from doesn't */
+static bool report_adds_press(bool nkro, const report_keyboard_t *from, const report_keyboard_t *to) {
+#ifdef NKRO_ENABLE
+    if (nkro) {
+        if (to->nkro.mods & ~from->nkro.mods) return true;
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if (to->nkro.bits[i] & ~from->nkro.bits[i]) return true;
+        }
+        return false;
+    }
+#endif
+    if (to->mods & ~from->mods) return true;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (to->keys[i] && !report_has_key(from, to->keys[i])) return true;
+    }
+    return false;
+}
+
+/* next can stand in for tail if no key that changed from prev to tail changes back,
+ * and next doesn't press something on top of a press tail is already carrying,
+ * since the host would get both presses at once and lose their order */
+static bool report_can_replace(bool nkro, const report_keyboard_t *prev, const report_keyboard_t *tail, const report_keyboard_t *next) {
+    if (report_adds_press(nkro, prev, tail) && report_adds_press(nkro, tail, next)) return false;
+#ifdef NKRO_ENABLE
+    if (nkro) {
+        if ((prev->nkro.mods ^ tail->nkro.mods) & (tail->nkro.mods ^ next->nkro.mods)) return false;
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if ((prev->nkro.bits[i] ^ tail->nkro.bits[i]) & (tail->nkro.bits[i] ^ next->nkro.bits[i])) return false;
+        }
+        return true;
+    }
+#endif
+    if ((prev->mods ^ tail->mods) & (tail->mods ^ next->mods)) return false;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t pressed = tail->keys[i];
+        if (pressed && !report_has_key(prev, pressed) && !report_has_key(next, pressed)) return false;
+
+        uint8_t released = prev->keys[i];
+        if (released && !report_has_key(tail, released) && report_has_key(next, released)) return false;
+    }
+    return true;
+}
+
+void report_queue_init(report_queue_t *queue, bool nkro) {
+    memset(queue, 0, sizeof(report_queue_t));
+    queue->nkro = nkro;
+#if defined(NKRO_ENABLE) && defined(NKRO_SHARED_EP)
+    if (nkro) queue->reports[0].nkro.report_id = REPORT_ID_NKRO;
+#endif
+#ifdef KEYBOARD_SHARED_EP
+    if (!nkro) queue->reports[0].report_id = REPORT_ID_KEYBOARD;
+#endif
+}
+
+/* the report queued before the newest one, or the one sent if there is none */
+static const report_keyboard_t *queue_prev(const report_queue_t *queue) {
+    uint8_t index = queue->count > 1 ? queue_index(queue, queue->count - 2) : queue->sent;
+    return &queue->reports[index];
+}
+
+bool report_queue_has_room(const report_queue_t *queue, const report_keyboard_t *report) {
+    if (queue->count < REPORT_QUEUE_SIZE || report_equal(report, report_queue_newest(queue))) return true;
+    return report_can_replace(queue->nkro, queue_prev(queue), report_queue_newest(queue), report);
+}
+
+bool report_queue_push(report_queue_t *queue, const report_keyboard_t *report) {
+    if (report_equal(report, report_queue_newest(queue))) return true;
+
+    if (queue->count) {
+        report_keyboard_t *      tail = &queue->reports[queue_index(queue, queue->count - 1)];
+        const report_keyboard_t *prev = queue_prev(queue);
+
+        // Latest state wins when the queue is still full, even if a change is lost
+        bool replaced = report_can_replace(queue->nkro, prev, tail, report);
+        if (replaced || queue->count == REPORT_QUEUE_SIZE) {
+            *tail = *report;
+            if (report_equal(tail, prev)) queue->count--;
+            return replaced;
+        }
+    }
+
+    queue->reports[queue_index(queue, queue->count)] = *report;
+    queue->count++;
+    return true;
+}
+
+bool report_queue_pop(report_queue_t *queue) {
+    if (!queue->count) return false;
+
+    queue->sent = queue_index(queue, 0);
+    queue->count--;
+    return true;
+}
+
+bool report_queue_is_empty(const report_queue_t *queue) { return !queue->count; }
+
+const report_keyboard_t *report_queue_newest(const report_queue_t *queue) {
+    uint8_t index = queue->count ? queue_index(queue, queue->count - 1) : queue->sent;
+    return &queue->reports[index];
+}
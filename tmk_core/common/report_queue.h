@@ -0,0 +1,78 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "report.h"
+
+/* Keyboard reports waiting for a busy endpoint.
+ *
+ * A report that only moves keys further along replaces the newest queued one,
+ * so the host gets the latest state as soon as the endpoint frees up. A report
+ * that undoes a queued change, like the release of a key pressed since the last
+ * report sent, is queued behind it so the host sees both. So is a report that
+ * presses a key or modifier while the newest queued one presses another, so
+ * the host gets the presses in the order they happened.
+ *
+ * A full queue can't hold another change. The protocol code waits for the host
+ * to take a report while report_queue_has_room() is false, and only if the host
+ * stops reading does the latest state replace the newest queued change.
+ *
+ * The queue does no locking, the protocol code serializes access.
+ */
+
+#ifndef REPORT_QUEUE_SIZE
+#    define REPORT_QUEUE_SIZE 4
+#endif
+
+#if REPORT_QUEUE_SIZE < 1 || REPORT_QUEUE_SIZE > 254
+#    error "REPORT_QUEUE_SIZE must be between 1 and 254"
+#endif
+
+typedef struct {
+    /* one slot more than the queue holds, for the report the endpoint sends from */
+    report_keyboard_t reports[REPORT_QUEUE_SIZE + 1];
+    /* slot of the last report taken off the queue, the queued ones follow it */
+    uint8_t sent;
+    uint8_t count;
+    bool    nkro;
+} report_queue_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* nkro selects the bitmap report layout for the reports on this queue */
+void report_queue_init(report_queue_t *queue, bool nkro);
+/* whether report can be pushed without dropping a queued change */
+bool report_queue_has_room(const report_queue_t *queue, const report_keyboard_t *report);
+/* false when the queue was full and a queued change had to be dropped */
+bool report_queue_push(report_queue_t *queue, const report_keyboard_t *report);
+/* hands the oldest report over to the endpoint, false when there is none */
+bool report_queue_pop(report_queue_t *queue);
+bool report_queue_is_empty(const report_queue_t *queue);
+
+/* the last report popped, which stays put until the next pop */
+static inline report_keyboard_t *report_queue_sent(report_queue_t *queue) { return &queue->reports[queue->sent]; }
+/* the newest report, queued or not */
+const report_keyboard_t *report_queue_newest(const report_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,99 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "report_scheduler.h"
+
+/* the mouse descriptor's logical range */
+#define MOUSE_MOVE_MAX 127
+
+void report_scheduler_init(report_scheduler_t *scheduler) { memset(scheduler, 0, sizeof(report_scheduler_t)); }
+
+bool report_scheduler_push_extra(report_scheduler_t *scheduler, const report_extra_t *report) {
+    bool kept = true;
+
+    if (scheduler->extra_count == EXTRA_QUEUE_SIZE) {
+        // Drop the oldest report a newer one of the same ID supersedes, which may be half of a tap
+        uint8_t drop = 0;
+        for (; drop < EXTRA_QUEUE_SIZE - 1; drop++) {
+            if (scheduler->extra[drop].report_id == report->report_id) break;
+            uint8_t i = drop + 1;
+            while (i < EXTRA_QUEUE_SIZE && scheduler->extra[i].report_id != scheduler->extra[drop].report_id) i++;
+            if (i < EXTRA_QUEUE_SIZE) break;
+        }
+        memmove(&scheduler->extra[drop], &scheduler->extra[drop + 1], (EXTRA_QUEUE_SIZE - 1 - drop) * sizeof(report_extra_t));
+        scheduler->extra_count--;
+        kept = false;
+    }
+
+    scheduler->extra[scheduler->extra_count++] = *report;
+    return kept;
+}
+
+/* moves as much of from's movement on an axis into to as the report can hold, leaving the rest in from */
+static bool add_axis(int8_t *to, int8_t *from) {
+    int16_t sum   = *to + *from;
+    int16_t fits  = sum > MOUSE_MOVE_MAX ? MOUSE_MOVE_MAX : sum < -MOUSE_MOVE_MAX ? -MOUSE_MOVE_MAX : sum;
+    *to   = fits;
+    *from = sum - fits;
+    return !*from;
+}
+
+static bool add_movement(report_mouse_t *to, report_mouse_t *from) {
+    bool all = add_axis(&to->x, &from->x);
+    all &= add_axis(&to->y, &from->y);
+    all &= add_axis(&to->v, &from->v);
+    all &= add_axis(&to->h, &from->h);
+    return all;
+}
+
+bool report_scheduler_push_mouse(report_scheduler_t *scheduler, const report_mouse_t *report) {
+    report_mouse_t next = *report;
+
+    if (scheduler->mouse_count) {
+        report_mouse_t *tail = &scheduler->mouse[scheduler->mouse_count - 1];
+        if (tail->buttons == next.buttons && add_movement(tail, &next)) return true;
+
+        if (scheduler->mouse_count == MOUSE_QUEUE_SIZE) {
+            // Latest buttons win, movement beyond what the report holds is lost
+            bool kept     = tail->buttons == next.buttons;
+            tail->buttons = next.buttons;
+            return add_movement(tail, &next) && kept;
+        }
+    }
+
+    scheduler->mouse[scheduler->mouse_count++] = next;
+    return true;
+}
+
+uint8_t report_scheduler_pop(report_scheduler_t *scheduler) {
+    if (scheduler->extra_count) {
+        scheduler->sent.extra = scheduler->extra[0];
+        scheduler->extra_count--;
+        memmove(&scheduler->extra[0], &scheduler->extra[1], scheduler->extra_count * sizeof(report_extra_t));
+        return sizeof(report_extra_t);
+    }
+    if (scheduler->mouse_count) {
+        scheduler->sent.mouse = scheduler->mouse[0];
+        scheduler->mouse_count--;
+        memmove(&scheduler->mouse[0], &scheduler->mouse[1], scheduler->mouse_count * sizeof(report_mouse_t));
+        return sizeof(report_mouse_t);
+    }
+    return 0;
+}
+
+bool report_scheduler_is_empty(const report_scheduler_t *scheduler) { return !scheduler->extra_count && !scheduler->mouse_count; }
@@ -0,0 +1,83 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "report.h"
+
+/* System, consumer and mouse reports waiting for a busy endpoint.
+ *
+ * Keyboard reports have their own report_queue_t, which the protocol code
+ * empties first, so the scheduler only runs when the endpoint would otherwise
+ * sit idle. Of what is left, system and consumer reports go before mouse ones.
+ *
+ * A mouse report with the same buttons as the newest queued one adds its
+ * movement to it, so however fast the sensor is read the host gets one report
+ * per poll with all of the movement. A button change gets a report of its own.
+ *
+ * The scheduler does no locking, the protocol code serializes access.
+ */
+
+#ifndef EXTRA_QUEUE_SIZE
+#    define EXTRA_QUEUE_SIZE 4
+#endif
+
+#ifndef MOUSE_QUEUE_SIZE
+#    define MOUSE_QUEUE_SIZE 2
+#endif
+
+/* room for a system and a consumer report at least */
+#if EXTRA_QUEUE_SIZE < 2 || EXTRA_QUEUE_SIZE > 255
+#    error "EXTRA_QUEUE_SIZE must be between 2 and 255"
+#endif
+
+#if MOUSE_QUEUE_SIZE < 1 || MOUSE_QUEUE_SIZE > 255
+#    error "MOUSE_QUEUE_SIZE must be between 1 and 255"
+#endif
+
+typedef struct {
+    report_extra_t extra[EXTRA_QUEUE_SIZE];
+    report_mouse_t mouse[MOUSE_QUEUE_SIZE];
+    uint8_t        extra_count;
+    uint8_t        mouse_count;
+    /* the report the endpoint sends from, which stays put until the next pop */
+    union {
+        report_extra_t extra;
+        report_mouse_t mouse;
+    } sent;
+} report_scheduler_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void report_scheduler_init(report_scheduler_t *scheduler);
+/* false when the queue was full and an older report had to be dropped, the latest state of each report ID is kept */
+bool report_scheduler_push_extra(report_scheduler_t *scheduler, const report_extra_t *report);
+/* false when the queue was full and a button change or some movement was lost */
+bool report_scheduler_push_mouse(report_scheduler_t *scheduler, const report_mouse_t *report);
+/* moves the next report into the sent slot and returns its size, 0 when there is none */
+uint8_t report_scheduler_pop(report_scheduler_t *scheduler);
+bool    report_scheduler_is_empty(const report_scheduler_t *scheduler);
+
+static inline uint8_t *report_scheduler_sent(report_scheduler_t *scheduler) { return (uint8_t *)&scheduler->sent; }
+
+#ifdef __cplusplus
+}
+#endif
@@ -16,7 +16,9 @@
 
 #include "eeprom.h"
 
-#define EEPROM_SIZE 32
+#ifndef EEPROM_SIZE
+#    define EEPROM_SIZE 32
+#endif
 
 static uint8_t buffer[EEPROM_SIZE];
 
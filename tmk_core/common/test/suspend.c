@@ -13,3 +13,42 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+
+#include "suspend.h"
+#include "keyboard.h"
+#include "matrix.h"
+#include "action.h"
+#include "led.h"
+#include "host.h"
+
+/* The host side of suspend and resume is simulated by the tests, see TestDriver */
+
+void suspend_idle(uint8_t time) {}
+
+__attribute__((weak)) void suspend_power_down_user(void) {}
+__attribute__((weak)) void suspend_power_down_kb(void) { suspend_power_down_user(); }
+
+void suspend_power_down(void) { suspend_power_down_kb(); }
+
+bool suspend_wakeup_condition(void) {
+#ifdef WAKE_KEY_BUFFER_SIZE
+    return keyboard_suspended_scan();
+#else
+    matrix_scan();
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        if (matrix_get_row(r)) return true;
+    }
+    return false;
+#endif
+}
+
+__attribute__((weak)) void suspend_wakeup_init_user(void) {}
+__attribute__((weak)) void suspend_wakeup_init_kb(void) { suspend_wakeup_init_user(); }
+
+void suspend_wakeup_init(void) {
+#ifndef WAKE_KEY_BUFFER_SIZE
+    clear_keyboard();
+#endif
+    led_set(host_keyboard_leds());
+    suspend_wakeup_init_kb();
+}
@@ -0,0 +1,103 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <string>
+
+extern "C" {
+#include "console_buffer.h"
+}
+
+// Reads the console in packets of 8 bytes, like an endpoint would
+class ConsoleBufferTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        console_buffer_init(&buffer);
+        host.clear();
+    }
+
+    unsigned print(const std::string &s) {
+        unsigned dropped = 0;
+        for (char c : s) {
+            if (!console_buffer_put(&buffer, c)) dropped++;
+        }
+        return dropped;
+    }
+
+    void read(unsigned packets = 1) {
+        while (packets--) {
+            uint8_t data[8];
+            uint8_t size = console_buffer_peek(&buffer, data, sizeof(data));
+            host.append((const char *)data, size);
+            console_buffer_skip(&buffer, size);
+        }
+    }
+
+    console_buffer_t buffer;
+    std::string      host;
+};
+
+TEST_F(ConsoleBufferTest, OutputComesOutInOrder) {
+    EXPECT_EQ(0u, print("hello, world\n"));
+    EXPECT_EQ(13, console_buffer_count(&buffer));
+    read(2);
+    EXPECT_EQ("hello, world\n", host);
+    EXPECT_EQ(0, console_buffer_count(&buffer));
+}
+
+TEST_F(ConsoleBufferTest, PeekLeavesOutputInTheBuffer) {
+    print("abc");
+    uint8_t data[8];
+    EXPECT_EQ(3, console_buffer_peek(&buffer, data, sizeof(data)));
+    EXPECT_EQ(3, console_buffer_peek(&buffer, data, sizeof(data)));
+    console_buffer_skip(&buffer, 1);
+    EXPECT_EQ(2, console_buffer_peek(&buffer, data, sizeof(data)));
+    EXPECT_EQ('b', data[0]);
+}
+
+TEST_F(ConsoleBufferTest, OutputWrapsAroundTheBuffer) {
+    for (unsigned i = 0; i < 10; i++) {
+        print("0123456789");
+        read(2);
+    }
+    std::string expected;
+    for (unsigned i = 0; i < 10; i++) {
+        expected += "0123456789";
+    }
+    EXPECT_EQ(expected, host);
+}
+
+TEST_F(ConsoleBufferTest, FullBufferDropsOutputAndSaysSo) {
+    EXPECT_EQ(0u, print(std::string(32, 'a')));
+    EXPECT_EQ(3u, print("bcd"));
+    // The note needs room for itself before anything else is buffered
+    read(1);
+    EXPECT_EQ(1u, print("e"));
+    read(3);
+    EXPECT_EQ(0u, print("f"));
+    read(5);
+    EXPECT_EQ(std::string(32, 'a') + "\n[4 bytes dropped]\nf", host);
+}
+
+TEST_F(ConsoleBufferTest, DroppedCountSaturates) {
+    print(std::string(32, 'a'));
+    print(std::string(70000, 'b'));
+    EXPECT_EQ(UINT16_MAX, buffer.dropped);
+    read(4);
+    print("c");
+    read(4);
+    EXPECT_EQ(std::string(32, 'a') + "\n[65535 bytes dropped]\nc", host);
+}
@@ -0,0 +1,249 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+extern "C" {
+#include "report_queue.h"
+}
+
+// An endpoint the host reads from every poll, that stays busy for a number of polls after each report
+class ReportQueueTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        report_queue_init(&queue, false);
+        busy_polls = 0;
+        busy       = 0;
+        host.clear();
+    }
+
+    static report_keyboard_t report(uint8_t mods, std::initializer_list<uint8_t> keys) {
+        report_keyboard_t report = {};
+        report.mods              = mods;
+        uint8_t i                = 0;
+        for (uint8_t key : keys) {
+            report.keys[i++] = key;
+        }
+        return report;
+    }
+
+    // What send_keyboard() does: wait for the host while the report would drop a queued change,
+    // then queue it, and send it right away if the endpoint is free
+    void send(const report_keyboard_t &report) {
+        for (unsigned i = 0; i < 255 && !report_queue_has_room(&queue, &report); i++) {
+            poll();
+        }
+        EXPECT_TRUE(report_queue_push(&queue, &report));
+        send_queued();
+    }
+
+    // What the IN-complete callback does
+    void poll(unsigned polls = 1) {
+        while (polls--) {
+            if (busy) busy--;
+            send_queued();
+        }
+    }
+
+    void send_queued(void) {
+        if (busy || !report_queue_pop(&queue)) return;
+        host.push_back(*report_queue_sent(&queue));
+        busy = busy_polls;
+    }
+
+    void expect_host(std::initializer_list<report_keyboard_t> expected) {
+        ASSERT_EQ(host.size(), expected.size());
+        size_t i = 0;
+        for (const report_keyboard_t &report : expected) {
+            EXPECT_EQ(0, memcmp(&host[i], &report, sizeof(report_keyboard_t))) << "report " << i;
+            i++;
+        }
+    }
+
+    report_queue_t                 queue;
+    unsigned                       busy_polls;
+    unsigned                       busy;
+    std::vector<report_keyboard_t> host;
+};
+
+TEST_F(ReportQueueTest, IdleEndpointSendsEveryReport) {
+    send(report(0, {KC_A}));
+    send(report(0, {KC_A, KC_B}));
+    send(report(0, {KC_B}));
+    send(report(0, {}));
+    expect_host({report(0, {KC_A}), report(0, {KC_A, KC_B}), report(0, {KC_B}), report(0, {})});
+    EXPECT_TRUE(report_queue_is_empty(&queue));
+}
+
+TEST_F(ReportQueueTest, RepeatedReportIsNotSent) {
+    send(report(0, {KC_A}));
+    send(report(0, {KC_A}));
+    poll(5);
+    expect_host({report(0, {KC_A})});
+}
+
+TEST_F(ReportQueueTest, PressesWhileBusyKeepTheirOrder) {
+    busy_polls = 4;
+    send(report(0, {KC_A}));
+    send(report(0, {KC_A, KC_B}));
+    send(report(0, {KC_A, KC_B, KC_C}));
+    poll(12);
+    expect_host({report(0, {KC_A}), report(0, {KC_A, KC_B}), report(0, {KC_A, KC_B, KC_C})});
+}
+
+TEST_F(ReportQueueTest, ModifierPressedAfterKeyWhileBusyKeepsItsOrder) {
+    busy_polls = 4;
+    send(report(0, {KC_B}));
+    // 'a' and then shift while 'a' is held types "a", not "A"
+    send(report(0, {KC_A}));
+    send(report(MOD_BIT(KC_LSFT), {KC_A}));
+    poll(8);
+    expect_host({report(0, {KC_B}), report(0, {KC_A}), report(MOD_BIT(KC_LSFT), {KC_A})});
+}
+
+TEST_F(ReportQueueTest, ReleasesWhileBusyAreCoalesced) {
+    busy_polls = 4;
+    send(report(0, {KC_A, KC_B, KC_C}));
+    send(report(0, {KC_A, KC_B}));
+    send(report(0, {KC_A}));
+    send(report(0, {}));
+    poll(4);
+    expect_host({report(0, {KC_A, KC_B, KC_C}), report(0, {})});
+}
+
+TEST_F(ReportQueueTest, TapWhileBusyIsKept) {
+    busy_polls = 4;
+    send(report(0, {KC_A}));
+    send(report(0, {KC_A, KC_B}));
+    send(report(0, {KC_A}));
+    poll(8);
+    expect_host({report(0, {KC_A}), report(0, {KC_A, KC_B}), report(0, {KC_A})});
+}
+
+TEST_F(ReportQueueTest, ReleaseAndPressAgainWhileBusyIsKept) {
+    busy_polls = 4;
+    send(report(0, {KC_A}));
+    send(report(0, {}));
+    send(report(0, {KC_A}));
+    poll(8);
+    expect_host({report(0, {KC_A}), report(0, {}), report(0, {KC_A})});
+}
+
+TEST_F(ReportQueueTest, ModifierTapWhileBusyIsKept) {
+    busy_polls = 4;
+    send(report(0, {KC_A}));
+    send(report(MOD_BIT(KC_LSFT), {KC_A}));
+    send(report(0, {KC_A}));
+    poll(8);
+    expect_host({report(0, {KC_A}), report(MOD_BIT(KC_LSFT), {KC_A}), report(0, {KC_A})});
+}
+
+TEST_F(ReportQueueTest, KeysMovingSlotsAreNotChanges) {
+    busy_polls = 4;
+    send(report(0, {KC_A}));
+    send(report(0, {KC_A, KC_B}));
+    send(report(0, {KC_B, KC_A}));
+    poll(4);
+    expect_host({report(0, {KC_A}), report(0, {KC_B, KC_A})});
+}
+
+TEST_F(ReportQueueTest, BurstOfTapsIsNeverDropped) {
+    busy_polls = 4;
+    std::vector<uint8_t> typed;
+    // What a SEND_STRING does, with many more taps than the queue holds
+    for (uint8_t key = KC_A; key < KC_A + 4 * REPORT_QUEUE_SIZE; key++) {
+        send(report(0, {key}));
+        send(report(0, {}));
+        typed.push_back(key);
+    }
+    poll(REPORT_QUEUE_SIZE * 5);
+
+    // A release may go out with the next press, but the host sees every key go down and up
+    std::vector<uint8_t> pressed;
+    report_keyboard_t    prev = report(0, {});
+    for (const report_keyboard_t &sent : host) {
+        if (sent.keys[0] && sent.keys[0] != prev.keys[0]) pressed.push_back(sent.keys[0]);
+        prev = sent;
+    }
+    EXPECT_EQ(typed, pressed);
+    report_keyboard_t empty = report(0, {});
+    EXPECT_EQ(0, memcmp(&host.back(), &empty, sizeof(report_keyboard_t)));
+}
+
+TEST_F(ReportQueueTest, FullQueueKeepsTheLatestState) {
+    busy_polls = 100;
+    send(report(0, {KC_A}));
+    // Three taps while the queue holds three reports, and the host stops reading
+    for (uint8_t key : {KC_B, KC_C, KC_D}) {
+        send(report(0, {KC_A, key}));
+        if (key == KC_D) {
+            report_keyboard_t released = report(0, {KC_A});
+            EXPECT_FALSE(report_queue_push(&queue, &released));
+        } else {
+            send(report(0, {KC_A}));
+        }
+    }
+    poll(400);
+    // The release of B and the press of C go out together, the tap of D is lost
+    expect_host({report(0, {KC_A}), report(0, {KC_A, KC_B}), report(0, {KC_A, KC_C}), report(0, {KC_A})});
+}
+
+TEST_F(ReportQueueTest, SendingNeverWaitsForTheHost) {
+    busy_polls = 1000;
+    for (unsigned i = 0; i < 100; i++) {
+        report_keyboard_t pressed = report(0, {KC_A});
+        report_keyboard_t empty   = report(0, {});
+        report_queue_push(&queue, &pressed);
+        report_queue_push(&queue, &empty);
+    }
+    EXPECT_LE(queue.count, REPORT_QUEUE_SIZE);
+    poll(REPORT_QUEUE_SIZE * 1001);
+    EXPECT_TRUE(report_queue_is_empty(&queue));
+    EXPECT_EQ(0, memcmp(&host.back(), report_queue_sent(&queue), sizeof(report_keyboard_t)));
+    report_keyboard_t empty = report(0, {});
+    EXPECT_EQ(0, memcmp(&host.back(), &empty, sizeof(report_keyboard_t)));
+}
+
+TEST_F(ReportQueueTest, ReportRateBenchmark) {
+    // Rolling over four keys, with a host that reads a report every fourth poll
+    const report_keyboard_t reports[] = {
+        report(0, {KC_A}), report(0, {KC_A, KC_S}), report(0, {KC_S}), report(0, {KC_S, KC_D}), report(0, {KC_D}), report(0, {KC_D, KC_F}), report(0, {KC_F}), report(0, {}),
+    };
+    const unsigned count = 1000000;
+    busy_polls           = 3;
+
+    unsigned sent  = 0;
+    auto     start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; i++) {
+        report_queue_push(&queue, &reports[i % 8]);
+        if (busy) {
+            busy--;
+        } else if (report_queue_pop(&queue)) {
+            busy = busy_polls;
+            sent++;
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%u reports in %.3f s, %.1f M reports/s, %u sent\n", count, elapsed, count / elapsed / 1e6, sent);
+
+    poll(REPORT_QUEUE_SIZE * 4);
+    EXPECT_TRUE(report_queue_is_empty(&queue));
+    EXPECT_EQ(0, memcmp(report_queue_sent(&queue), &reports[(count - 1) % 8], sizeof(report_keyboard_t)));
+}
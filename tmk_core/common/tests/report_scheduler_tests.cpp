@@ -0,0 +1,283 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+extern "C" {
+#include "report_queue.h"
+#include "report_scheduler.h"
+}
+
+// A shared endpoint the host reads from every poll, that stays busy for a number of polls after each report
+class ReportSchedulerTest : public ::testing::Test {
+   protected:
+    // What the host got, one of the three report types
+    struct sent_t {
+        char              type;
+        report_keyboard_t keyboard;
+        report_extra_t    extra;
+        report_mouse_t    mouse;
+    };
+
+    void SetUp() override {
+        report_queue_init(&keyboard_queue, false);
+        report_scheduler_init(&scheduler);
+        busy_polls = 0;
+        busy       = 0;
+        host.clear();
+    }
+
+    static report_keyboard_t keys(std::initializer_list<uint8_t> pressed) {
+        report_keyboard_t report = {};
+        uint8_t           i      = 0;
+        for (uint8_t key : pressed) {
+            report.keys[i++] = key;
+        }
+        return report;
+    }
+
+    static report_extra_t consumer(uint16_t usage) { return {REPORT_ID_CONSUMER, usage}; }
+    static report_extra_t system(uint16_t usage) { return {REPORT_ID_SYSTEM, usage}; }
+
+    static report_mouse_t mouse(uint8_t buttons, int8_t x, int8_t y, int8_t v = 0) {
+        report_mouse_t report = {};
+        report.buttons        = buttons;
+        report.x              = x;
+        report.y              = y;
+        report.v              = v;
+        return report;
+    }
+
+    // What send_keyboard(), send_extra() and send_mouse() do: queue the report, and send right away if the endpoint is free
+    void send(const report_keyboard_t &report) {
+        EXPECT_TRUE(report_queue_push(&keyboard_queue, &report));
+        send_queued();
+    }
+    void send(const report_extra_t &report) {
+        EXPECT_TRUE(report_scheduler_push_extra(&scheduler, &report));
+        send_queued();
+    }
+    void send(const report_mouse_t &report) {
+        EXPECT_TRUE(report_scheduler_push_mouse(&scheduler, &report));
+        send_queued();
+    }
+
+    // What the IN-complete callback does
+    void poll(unsigned polls = 1) {
+        while (polls--) {
+            if (busy) busy--;
+            send_queued();
+        }
+    }
+
+    // Keyboard reports first, the scheduler gets what is left
+    void send_queued(void) {
+        if (busy) return;
+        sent_t sent = {};
+        if (report_queue_pop(&keyboard_queue)) {
+            sent.type     = 'k';
+            sent.keyboard = *report_queue_sent(&keyboard_queue);
+        } else {
+            uint8_t size = report_scheduler_pop(&scheduler);
+            if (!size) return;
+            if (size == sizeof(report_extra_t)) {
+                sent.type = 'e';
+                memcpy(&sent.extra, report_scheduler_sent(&scheduler), size);
+            } else {
+                sent.type = 'm';
+                memcpy(&sent.mouse, report_scheduler_sent(&scheduler), size);
+            }
+        }
+        host.push_back(sent);
+        busy = busy_polls;
+    }
+
+    void expect_mouse(size_t index, const report_mouse_t &expected) {
+        ASSERT_LT(index, host.size());
+        EXPECT_EQ('m', host[index].type) << "report " << index;
+        EXPECT_EQ(0, memcmp(&host[index].mouse, &expected, sizeof(report_mouse_t))) << "report " << index;
+    }
+
+    void expect_extra(size_t index, const report_extra_t &expected) {
+        ASSERT_LT(index, host.size());
+        EXPECT_EQ('e', host[index].type) << "report " << index;
+        EXPECT_EQ(expected.report_id, host[index].extra.report_id) << "report " << index;
+        EXPECT_EQ(expected.usage, host[index].extra.usage) << "report " << index;
+    }
+
+    void expect_keyboard(size_t index, const report_keyboard_t &expected) {
+        ASSERT_LT(index, host.size());
+        EXPECT_EQ('k', host[index].type) << "report " << index;
+        EXPECT_EQ(0, memcmp(&host[index].keyboard, &expected, sizeof(report_keyboard_t))) << "report " << index;
+    }
+
+    report_queue_t      keyboard_queue;
+    report_scheduler_t  scheduler;
+    unsigned            busy_polls;
+    unsigned            busy;
+    std::vector<sent_t> host;
+};
+
+TEST_F(ReportSchedulerTest, IdleEndpointSendsEveryReport) {
+    send(mouse(0, 1, 2));
+    send(consumer(0xE9));
+    send(mouse(0, 3, 4));
+    send(consumer(0));
+    ASSERT_EQ(4u, host.size());
+    expect_mouse(0, mouse(0, 1, 2));
+    expect_extra(1, consumer(0xE9));
+    expect_mouse(2, mouse(0, 3, 4));
+    expect_extra(3, consumer(0));
+    EXPECT_TRUE(report_scheduler_is_empty(&scheduler));
+}
+
+TEST_F(ReportSchedulerTest, MovementWhileBusyIsMerged) {
+    busy_polls = 4;
+    send(mouse(0, 1, 1));
+    for (int i = 0; i < 10; i++) {
+        send(mouse(0, 2, -3, i == 5 ? 1 : 0));
+    }
+    poll(8);
+    ASSERT_EQ(2u, host.size());
+    expect_mouse(0, mouse(0, 1, 1));
+    expect_mouse(1, mouse(0, 20, -30, 1));
+}
+
+TEST_F(ReportSchedulerTest, ButtonChangeGetsItsOwnReport) {
+    busy_polls = 4;
+    send(mouse(0, 1, 0));
+    send(mouse(0, 5, 0));
+    send(mouse(1, 1, 0));
+    send(mouse(1, 1, 0));
+    poll(12);
+    ASSERT_EQ(3u, host.size());
+    expect_mouse(0, mouse(0, 1, 0));
+    expect_mouse(1, mouse(0, 5, 0));
+    expect_mouse(2, mouse(1, 2, 0));
+}
+
+TEST_F(ReportSchedulerTest, MovementBeyondOneReportSpillsOver) {
+    busy_polls = 4;
+    send(mouse(0, 0, 0));
+    send(mouse(0, 100, -100));
+    send(mouse(0, 100, -100));
+    poll(12);
+    ASSERT_EQ(3u, host.size());
+    expect_mouse(1, mouse(0, 127, -127));
+    expect_mouse(2, mouse(0, 73, -73));
+}
+
+TEST_F(ReportSchedulerTest, FullMouseQueueKeepsTheLatestButtons) {
+    busy_polls = 100;
+    send(mouse(0, 0, 0));
+    send(mouse(1, 0, 0));
+    send(mouse(0, 0, 0));
+    // The queue holds the press and the release, the next click is folded into the release
+    report_mouse_t pressed = mouse(1, 0, 0);
+    EXPECT_FALSE(report_scheduler_push_mouse(&scheduler, &pressed));
+    poll(300);
+    ASSERT_EQ(3u, host.size());
+    expect_mouse(1, mouse(1, 0, 0));
+    expect_mouse(2, mouse(1, 0, 0));
+}
+
+TEST_F(ReportSchedulerTest, TapWhileBusyIsKept) {
+    busy_polls = 4;
+    send(mouse(0, 1, 1));
+    send(consumer(0xE9));
+    send(consumer(0));
+    poll(8);
+    ASSERT_EQ(3u, host.size());
+    expect_extra(1, consumer(0xE9));
+    expect_extra(2, consumer(0));
+}
+
+TEST_F(ReportSchedulerTest, FullExtraQueueKeepsTheLatestState) {
+    busy_polls = 100;
+    send(mouse(0, 1, 1));
+    send(consumer(0xE9));
+    send(system(0x82));
+    send(consumer(0));
+    // The oldest report with a newer one of its ID queued goes
+    report_extra_t released = system(0);
+    EXPECT_FALSE(report_scheduler_push_extra(&scheduler, &released));
+    poll(400);
+    ASSERT_EQ(4u, host.size());
+    expect_extra(1, system(0x82));
+    expect_extra(2, consumer(0));
+    expect_extra(3, system(0));
+}
+
+TEST_F(ReportSchedulerTest, ExtraReportsGoBeforeMouse) {
+    busy_polls = 4;
+    send(mouse(0, 1, 1));
+    send(mouse(0, 1, 1));
+    send(system(0x82));
+    poll(8);
+    ASSERT_EQ(3u, host.size());
+    expect_extra(1, system(0x82));
+    expect_mouse(2, mouse(0, 1, 1));
+}
+
+TEST_F(ReportSchedulerTest, KeyboardGoesFirst) {
+    busy_polls = 4;
+    send(mouse(0, 1, 1));
+    send(mouse(0, 1, 1));
+    send(consumer(0xE9));
+    send(keys({KC_A}));
+    poll(12);
+    ASSERT_EQ(4u, host.size());
+    expect_keyboard(1, keys({KC_A}));
+    expect_extra(2, consumer(0xE9));
+    expect_mouse(3, mouse(0, 1, 1));
+}
+
+TEST_F(ReportSchedulerTest, MouseTrafficAddsNoKeyboardLatency) {
+    // A sensor read every poll, twice as fast as the host takes reports
+    busy_polls      = 2;
+    int      moved  = 0;
+    unsigned typed  = 0;
+    size_t   before = 0;
+    for (unsigned i = 0; i < 1000; i++) {
+        if (i % 50 == 25) {
+            send(i % 100 == 25 ? keys({KC_A}) : keys({}));
+            typed = i;
+        }
+        report_mouse_t moving = mouse(0, 3, 0);
+        EXPECT_TRUE(report_scheduler_push_mouse(&scheduler, &moving));
+        moved += 3;
+        poll();
+
+        // A key report waits for the report being sent at most, never for queued mouse reports
+        for (; before < host.size(); before++) {
+            if (host[before].type == 'k') EXPECT_LE(i - typed, busy_polls) << "poll " << i;
+        }
+    }
+    poll(8);
+
+    int      received = 0;
+    unsigned keyboard = 0;
+    for (const sent_t &sent : host) {
+        if (sent.type == 'm') received += sent.mouse.x;
+        if (sent.type == 'k') keyboard++;
+    }
+    EXPECT_EQ(moved, received);
+    EXPECT_EQ(20u, keyboard);
+    EXPECT_LE(host.size(), 1000u / busy_polls + 4);
+}
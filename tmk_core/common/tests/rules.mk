@@ -0,0 +1,22 @@
+# The letter case of these variables might seem odd. However:
+# - it is consistent with the serial_link example that is used as a reference in the Unit Testing article (https://docs.qmk.fm/#/unit_testing?id=adding-tests-for-new-or-existing-features)
+# - Neither `make test:report_queue` or `make test:REPORT_QUEUE` work when using SCREAMING_SNAKE_CASE
+
+report_queue_DEFS := -DREPORT_QUEUE_SIZE=3
+
+report_queue_SRC := \
+	$(TMK_PATH)/common/tests/report_queue_tests.cpp \
+	$(TMK_PATH)/common/report_queue.c
+
+report_scheduler_DEFS := -DEXTRA_QUEUE_SIZE=3 -DMOUSE_QUEUE_SIZE=2
+
+report_scheduler_SRC := \
+	$(TMK_PATH)/common/tests/report_scheduler_tests.cpp \
+	$(TMK_PATH)/common/report_queue.c \
+	$(TMK_PATH)/common/report_scheduler.c
+
+console_buffer_DEFS := -DCONSOLE_BUFFER_SIZE=32
+
+console_buffer_SRC := \
+	$(TMK_PATH)/common/tests/console_buffer_tests.cpp \
+	$(TMK_PATH)/common/console_buffer.c
@@ -0,0 +1 @@
+TEST_LIST += report_queue report_scheduler console_buffer
@@ -59,6 +59,9 @@
 #endif
 #include "suspend.h"
 #include "wait.h"
+#ifdef MATRIX_SCAN_THREAD_ENABLE
+#    include "matrix_thread.h"
+#endif
 
 /* -------------------------
  *   TMK host driver defs
@@ -110,6 +113,35 @@ void midi_ep_task(void);
 //   }
 // }
 
+#ifdef MATRIX_SCAN_THREAD_ENABLE
+#    ifndef MATRIX_SCAN_THREAD_PRIORITY
+#        define MATRIX_SCAN_THREAD_PRIORITY (NORMALPRIO + 16)
+#    endif
+#    ifndef MATRIX_SCAN_THREAD_STACK
+#        define MATRIX_SCAN_THREAD_STACK 512
+#    endif
+#    ifndef MATRIX_SCAN_INTERVAL_US
+#        define MATRIX_SCAN_INTERVAL_US 1000
+#    endif
+
+/* Matrix thread: scans at a fixed rate, above the main loop so lighting
+ * and OLED updates can't delay it.
+ */
+static THD_WORKING_AREA(waMatrixThread, MATRIX_SCAN_THREAD_STACK);
+static THD_FUNCTION(MatrixThread, arg) {
+    (void)arg;
+    chRegSetThreadName("matrix");
+
+    systime_t next = chVTGetSystemTime();
+    while (true) {
+        matrix_thread_task();
+        next = chThdSleepUntilWindowed(next, chTimeAddX(next, TIME_US2I(MATRIX_SCAN_INTERVAL_US)));
+    }
+}
+
+void matrix_thread_start(void) { chThdCreateStatic(waMatrixThread, sizeof(waMatrixThread), MATRIX_SCAN_THREAD_PRIORITY, MatrixThread, NULL); }
+#endif
+
 /* Early initialisation
  */
 __attribute__((weak)) void early_hardware_init_pre(void) {
@@ -213,6 +245,9 @@ int main(void) {
     /* init TMK modules */
     keyboard_init();
     host_set_driver(driver);
+#ifdef MATRIX_SCAN_THREAD_ENABLE
+    matrix_thread_start();
+#endif
 
 #ifdef SLEEP_LED_ENABLE
     sleep_led_init();
@@ -236,8 +271,13 @@ int main(void) {
                 serial_link_update();
 #    endif
                 suspend_power_down();  // on AVR this deep sleeps for 15ms
-                /* Remote wakeup */
-                if (suspend_wakeup_condition()) {
+                /* Remote wakeup, if the host allows it */
+#    ifdef WAKE_KEY_BUFFER_SIZE
+                // scan anyway, the host may wake up by itself
+                if (suspend_wakeup_condition() && (USB_DRIVER.status & USB_GETSTATUS_REMOTE_WAKEUP_ENABLED)) {
+#    else
+                if ((USB_DRIVER.status & USB_GETSTATUS_REMOTE_WAKEUP_ENABLED) && suspend_wakeup_condition()) {
+#    endif
                     usbWakeupHost(&USB_DRIVER);
                     restart_usb_driver(&USB_DRIVER);
                 }
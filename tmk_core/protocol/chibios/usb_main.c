@@ -41,6 +41,10 @@
 #include "wait.h"
 #include "usb_descriptor.h"
 #include "usb_driver.h"
+#include "report_queue.h"
+#include "report_scheduler.h"
+#include "console_buffer.h"
+#include "timer.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -72,7 +76,18 @@ volatile uint16_t      keyboard_idle_count                           = 0;
 static virtual_timer_t keyboard_idle_timer;
 static void            keyboard_idle_timer_cb(void *arg);
 
-report_keyboard_t keyboard_report_sent = {{0}};
+/* Keyboard reports waiting for their endpoint, sent straight from the queue by the IN callbacks */
+static report_queue_t keyboard_queue;
+#ifdef NKRO_ENABLE
+static report_queue_t nkro_queue = {.nkro = true};
+#endif
+/* System, consumer and mouse reports, sent by the same IN callbacks once no keyboard report is waiting */
+#ifdef SHARED_EP_ENABLE
+static report_scheduler_t shared_scheduler;
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+static report_scheduler_t mouse_scheduler;
+#endif
 #ifdef MOUSE_ENABLE
 report_mouse_t mouse_report_blank = {0};
 #endif /* MOUSE_ENABLE */
@@ -441,6 +456,17 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
 
         case USB_EVENT_CONFIGURED:
             osalSysLockFromISR();
+            /* Drop reports meant for the previous configuration */
+            report_queue_init(&keyboard_queue, false);
+#ifdef NKRO_ENABLE
+            report_queue_init(&nkro_queue, true);
+#endif
+#ifdef SHARED_EP_ENABLE
+            report_scheduler_init(&shared_scheduler);
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+            report_scheduler_init(&mouse_scheduler);
+#endif
             /* Enable the endpoints specified into the configuration. */
 #ifndef KEYBOARD_SHARED_EP
             usbInitEndpointI(usbp, KEYBOARD_IN_EPNUM, &kbd_ep_config);
@@ -549,7 +575,7 @@ static bool usb_request_hook_cb(USBDriver *usbp) {
                     case HID_GET_REPORT:
                         switch (usbp->setup[4]) { /* LSB(wIndex) (check MSB==0?) */
                             case KEYBOARD_INTERFACE:
-                                usbSetupTransfer(usbp, (uint8_t *)&keyboard_report_sent, sizeof(keyboard_report_sent), NULL);
+                                usbSetupTransfer(usbp, (uint8_t *)report_queue_newest(&keyboard_queue), sizeof(report_keyboard_t), NULL);
                                 return TRUE;
                                 break;
 
@@ -727,19 +753,117 @@ void restart_usb_driver(USBDriver *usbp) {
  *                  Keyboard functions
  * ---------------------------------------------------------
  */
+#ifdef DEBUG_USB_LATENCY
+/* Time from send_keyboard() until the host has read the report, or a newer one,
+ * in frames counted by the SOF callback: 1ms, or 125us microframes at high speed */
+#    ifdef USB_HIGH_SPEED
+#        define USB_FRAME_US 125
+#    else
+#        define USB_FRAME_US 1000
+#    endif
+
+static volatile uint16_t     usb_frame_count = 0;
+static const report_queue_t *latency_queue   = NULL;
+static uint16_t              latency_start;
+static uint16_t              latency_count = 0;
+static uint16_t              latency_max   = 0;
+static uint32_t              latency_sum   = 0;
+static uint32_t              latency_timer = 0;
+
+/* only measured when no other report is on its way */
+static void usb_latency_start_I(const report_queue_t *queue) {
+    if (latency_queue || report_queue_is_empty(queue)) return;
+
+    latency_queue = queue;
+    latency_start = usb_frame_count;
+}
+
+/* called when a report has made it IN, before the next one is sent */
+static void usb_latency_stop_I(void) {
+    if (!latency_queue || !report_queue_is_empty(latency_queue)) return;
+
+    uint16_t frames = usb_frame_count - latency_start;
+    latency_queue   = NULL;
+    latency_sum += frames;
+    latency_count++;
+    if (frames > latency_max) latency_max = frames;
+}
+
+static void usb_latency_print(void) {
+    if (TIMER_DIFF_32(timer_read32(), latency_timer) < 1000) return;
+
+    osalSysLock();
+    uint16_t count = latency_count;
+    uint16_t max   = latency_max;
+    uint32_t sum   = latency_sum;
+    latency_count  = 0;
+    latency_max    = 0;
+    latency_sum    = 0;
+    osalSysUnlock();
+
+    latency_timer = timer_read32();
+    if (count) {
+        dprintf("usb latency: %u reports, avg %lu us, max %lu us\n", count, sum * USB_FRAME_US / count, (uint32_t)max * USB_FRAME_US);
+    }
+}
+#else
+#    define usb_latency_start_I(queue)
+#    define usb_latency_stop_I()
+#    define usb_latency_print()
+#endif
+
+/* start sending the oldest queued keyboard report if ep is idle
+ * the endpoint sends from the queue's sent slot, which is only reused once it is idle again */
+static void send_keyboard_queued_I(USBDriver *usbp, report_queue_t *queue, usbep_t ep) {
+    if (usbGetTransmitStatusI(usbp, ep) || !report_queue_pop(queue)) {
+        return;
+    }
+
+    /* boot protocol reports have no report ID */
+    report_keyboard_t *report = report_queue_sent(queue);
+    uint8_t *          data   = keyboard_protocol ? (uint8_t *)report : &report->mods;
+    uint8_t            size   = keyboard_protocol ? KEYBOARD_REPORT_SIZE : 8;
+#ifdef NKRO_ENABLE
+    if (queue->nkro) {
+        size = sizeof(struct nkro_report);
+    }
+#endif /* NKRO_ENABLE */
+    usbStartTransmitI(usbp, ep, data, size);
+}
+
+/* start sending the next scheduled report if ep is idle, from the scheduler's sent slot */
+#if defined(SHARED_EP_ENABLE) || defined(MOUSE_ENABLE)
+static void send_scheduled_I(USBDriver *usbp, report_scheduler_t *scheduler, usbep_t ep) {
+    if (usbGetTransmitStatusI(usbp, ep)) {
+        return;
+    }
+
+    uint8_t size = report_scheduler_pop(scheduler);
+    if (size) {
+        usbStartTransmitI(usbp, ep, report_scheduler_sent(scheduler), size);
+    }
+}
+#endif
+
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
+    osalSysLockFromISR();
+    usb_latency_stop_I();
+    send_keyboard_queued_I(usbp, &keyboard_queue, ep);
+    osalSysUnlockFromISR();
 }
 #endif
 
 /* start-of-frame handler
  * TODO: i guess it would be better to re-implement using timers,
  *  so that this is not going to have to be checked every 1ms */
-void kbd_sof_cb(USBDriver *usbp) { (void)usbp; }
+void kbd_sof_cb(USBDriver *usbp) {
+    (void)usbp;
+#ifdef DEBUG_USB_LATENCY
+    usb_frame_count++;
+#endif
+}
 
 /* Idle requests timer code
  * callback (called from ISR, unlocked state) */
@@ -761,8 +885,13 @@ static void keyboard_idle_timer_cb(void *arg) {
     if (keyboard_idle && keyboard_protocol) {
 #endif /* NKRO_ENABLE */
         /* TODO: are we sure we want the KBD_ENDPOINT? */
-        if (!usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM)) {
-            usbStartTransmitI(usbp, KEYBOARD_IN_EPNUM, (uint8_t *)&keyboard_report_sent, KEYBOARD_EPSIZE);
+        if (report_queue_is_empty(&keyboard_queue)) {
+            /* repeat the last report the host got */
+            if (!usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM)) {
+                usbStartTransmitI(usbp, KEYBOARD_IN_EPNUM, (uint8_t *)report_queue_sent(&keyboard_queue), KEYBOARD_EPSIZE);
+            }
+        } else {
+            send_keyboard_queued_I(usbp, &keyboard_queue, KEYBOARD_IN_EPNUM);
         }
         /* rearm the timer */
         chVTSetI(&keyboard_idle_timer, 4 * TIME_MS2I(keyboard_idle), keyboard_idle_timer_cb, (void *)usbp);
@@ -776,65 +905,47 @@ static void keyboard_idle_timer_cb(void *arg) {
 /* LED status */
 uint8_t keyboard_leds(void) { return keyboard_led_state; }
 
-/* prepare and start sending a report IN
+/* queue a report and start sending it if the endpoint is idle
+ * the IN callback sends what is left, only a full queue waits for the host
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
+    bool dropped = false;
+
     osalSysLock();
     if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
         goto unlock;
     }
 
+    report_queue_t *queue = &keyboard_queue;
+    usbep_t         ep    = KEYBOARD_IN_EPNUM;
 #ifdef NKRO_ENABLE
     if (keymap_config.nkro && keyboard_protocol) { /* NKRO protocol */
-        /* need to wait until the previous packet has made it through */
-        /* can rewrite this using the synchronous API, then would wait
-         * until *after* the packet has been transmitted. I think
-         * this is more efficient */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(struct nkro_report));
-    } else
+        queue = &nkro_queue;
+        ep    = SHARED_IN_EPNUM;
+    }
 #endif /* NKRO_ENABLE */
-    {  /* regular protocol */
-        /* need to wait until the previous packet has made it through */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, KEYBOARD_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[KEYBOARD_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
+    /* a full queue means the endpoint is busy, wait for its IN callback to send
+     * a queued report rather than lose a change, unless the host stops polling.
+     * needs USB_USE_WAIT == TRUE in halconf.h */
+    while (!report_queue_has_room(queue, report)) {
+        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[ep]->in_state->thread, TIME_MS2I(10)) != MSG_OK) {
+            break;
         }
-        uint8_t *data, size;
-        if (keyboard_protocol) {
-            data = (uint8_t *)report;
-            size = KEYBOARD_REPORT_SIZE;
-        } else { /* boot protocol */
-            data = &report->mods;
-            size = 8;
+        /* after osalThreadSuspendTimeoutS returns USB status might have changed */
+        if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+            goto unlock;
         }
-        usbStartTransmitI(&USB_DRIVER, KEYBOARD_IN_EPNUM, data, size);
     }
-    keyboard_report_sent = *report;
+    dropped = !report_queue_push(queue, report);
+    usb_latency_start_I(queue);
+    send_keyboard_queued_I(&USB_DRIVER, queue, ep);
 
 unlock:
     osalSysUnlock();
+    if (dropped) {
+        dprint("keyboard report queue full\n");
+    }
+    usb_latency_print();
 }
 
 /* ---------------------------------------------------------
@@ -847,11 +958,14 @@ unlock:
 #    ifndef MOUSE_SHARED_EP
 /* mouse IN callback hander (a mouse report has made it IN) */
 void mouse_in_cb(USBDriver *usbp, usbep_t ep) {
-    (void)usbp;
-    (void)ep;
+    osalSysLockFromISR();
+    send_scheduled_I(usbp, &mouse_scheduler, ep);
+    osalSysUnlockFromISR();
 }
 #    endif
 
+/* add the movement to the queued report, or queue the report, and send it if the endpoint is idle
+ * never waits for the host */
 void send_mouse(report_mouse_t *report) {
     osalSysLock();
     if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
@@ -859,18 +973,18 @@ void send_mouse(report_mouse_t *report) {
         return;
     }
 
-    if (usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[MOUSE_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-    usbStartTransmitI(&USB_DRIVER, MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
+#    ifdef MOUSE_SHARED_EP
+    report_scheduler_t *scheduler = &shared_scheduler;
+#    else
+    report_scheduler_t *scheduler = &mouse_scheduler;
+#    endif
+    bool kept = report_scheduler_push_mouse(scheduler, report);
+    /* keyboard reports only wait while the endpoint is busy, so none can be passed over here */
+    send_scheduled_I(&USB_DRIVER, scheduler, MOUSE_IN_EPNUM);
     osalSysUnlock();
+    if (!kept) {
+        dprint("mouse report queue full\n");
+    }
 }
 
 #else  /* MOUSE_ENABLE */
@@ -884,9 +998,17 @@ void send_mouse(report_mouse_t *report) { (void)report; }
 #ifdef SHARED_EP_ENABLE
 /* shared IN callback hander */
 void shared_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
-    (void)usbp;
-    (void)ep;
+    osalSysLockFromISR();
+    usb_latency_stop_I();
+#    ifdef KEYBOARD_SHARED_EP
+    send_keyboard_queued_I(usbp, &keyboard_queue, ep);
+#    endif
+#    ifdef NKRO_ENABLE
+    send_keyboard_queued_I(usbp, &nkro_queue, ep);
+#    endif
+    /* the rest only goes out if no keyboard report took the endpoint */
+    send_scheduled_I(usbp, &shared_scheduler, ep);
+    osalSysUnlockFromISR();
 }
 #endif
 
@@ -896,6 +1018,7 @@ void shared_in_cb(USBDriver *usbp, usbep_t ep) {
  */
 
 #ifdef EXTRAKEY_ENABLE
+/* queue the report and send it if the shared endpoint is idle, never waits for the host */
 static void send_extra(uint8_t report_id, uint16_t data) {
     osalSysLock();
     if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
@@ -905,8 +1028,12 @@ static void send_extra(uint8_t report_id, uint16_t data) {
 
     report_extra_t report = {.report_id = report_id, .usage = data};
 
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report_extra_t));
+    bool kept = report_scheduler_push_extra(&shared_scheduler, &report);
+    send_scheduled_I(&USB_DRIVER, &shared_scheduler, SHARED_IN_EPNUM);
     osalSysUnlock();
+    if (!kept) {
+        dprint("extra report queue full\n");
+    }
 }
 #endif
 
@@ -929,33 +1056,40 @@ void send_consumer(uint16_t data) {
 
 #ifdef CONSOLE_ENABLE
 
+static console_buffer_t console_buffer;
+static uint16_t         console_flush_timer;
+
+/* Never waits for the host, console_task() sends the output on later and what
+ * doesn't fit in the buffer is dropped. Callable from any context, so a print
+ * from an interrupt can't corrupt the buffer. */
 int8_t sendchar(uint8_t c) {
-    static bool timed_out = false;
-    /* The `timed_out` state is an approximation of the ideal `is_listener_disconnected?` state.
-     *
-     * When a 5ms timeout write has timed out, hid_listen is most likely not running, or not
-     * listening to this keyboard, so we go into the timed_out state. In this state we assume
-     * that hid_listen is most likely not gonna be connected to us any time soon, so it would
-     * be wasteful to write follow-up characters with a 5ms timeout, it would all add up and
-     * unncecessarily slow down the firmware. However instead of just dropping the characters,
-     * we write them with a TIME_IMMEDIATE timeout, which is a zero timeout,
-     * and this will succeed only if hid_listen gets connected again. When a write with
-     * TIME_IMMEDIATE timeout succeeds, we know that hid_listen is listening to us again, and
-     * we can go back to the timed_out = false state, and following writes will be executed
-     * with a 5ms timeout. The reason we don't just send all characters with the TIME_IMMEDIATE
-     * timeout is that this could cause bytes to be lost even if hid_listen is running, if there
-     * is a lot of data being sent over the console.
-     *
-     * This logic will work correctly as long as hid_listen is able to receive at least 200
-     * bytes per second. On a heavily overloaded machine that's so overloaded that it's
-     * unusable, and constantly swapping, hid_listen might have trouble receiving 200 bytes per
-     * second, so some bytes might be lost on the console.
-     */
+    syssts_t sts = osalSysGetStatusAndLockX();
+    bool     put = console_buffer_put(&console_buffer, c);
+    osalSysRestoreStatusX(sts);
+    return put ? 0 : -1;
+}
 
-    const sysinterval_t timeout = timed_out ? TIME_IMMEDIATE : TIME_MS2I(5);
-    const size_t        result  = chnWriteTimeout(&drivers.console_driver.driver, &c, 1, timeout);
-    timed_out                   = (result == 0);
-    return result;
+/* Hands buffered output to the driver a packet at a time, as far as its queue
+ * has room. A packet that isn't full yet waits up to CONSOLE_FLUSH_INTERVAL for
+ * more output, after which the driver flushes it at the next SOF. */
+static void console_send_buffered(void) {
+    osalSysLock();
+    uint16_t count = console_buffer_count(&console_buffer);
+    osalSysUnlock();
+    while (count >= CONSOLE_EPSIZE || (count && timer_elapsed(console_flush_timer) >= CONSOLE_FLUSH_INTERVAL)) {
+        uint8_t data[CONSOLE_EPSIZE];
+        osalSysLock();
+        uint8_t size = console_buffer_peek(&console_buffer, data, sizeof(data));
+        osalSysUnlock();
+        size_t sent = chnWriteTimeout(&drivers.console_driver.driver, data, size, TIME_IMMEDIATE);
+        osalSysLock();
+        console_buffer_skip(&console_buffer, sent);
+        osalSysUnlock();
+        if (sent < size) break;
+        count -= size;
+        console_flush_timer = timer_read();
+    }
+    if (!count) console_flush_timer = timer_read();
 }
 
 // Just a dummy function for now, this could be exposed as a weak function
@@ -966,6 +1100,8 @@ static void console_receive(uint8_t *data, uint8_t length) {
 }
 
 void console_task(void) {
+    console_send_buffered();
+
     uint8_t buffer[CONSOLE_EPSIZE];
     size_t  size = 0;
     do {
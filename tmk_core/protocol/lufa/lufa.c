@@ -51,8 +51,10 @@
 
 #include "usb_descriptor.h"
 #include "lufa.h"
+#include "report_queue.h"
+#include "report_scheduler.h"
+#include "console_buffer.h"
 #include "quantum.h"
-#include <util/atomic.h>
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -134,7 +136,18 @@ uint8_t keyboard_idle = 0;
 uint8_t        keyboard_protocol  = 1;
 static uint8_t keyboard_led_state = 0;
 
-static report_keyboard_t keyboard_report_sent;
+/* Keyboard reports waiting for their endpoint, sent straight from the queue */
+static report_queue_t keyboard_queue;
+#ifdef NKRO_ENABLE
+static report_queue_t nkro_queue = {.nkro = true};
+#endif
+/* System, consumer and mouse reports, sent once no keyboard report is waiting for the endpoint */
+#ifdef SHARED_EP_ENABLE
+static report_scheduler_t shared_scheduler;
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+static report_scheduler_t mouse_scheduler;
+#endif
 
 /* Host driver */
 static uint8_t keyboard_leds(void);
@@ -253,56 +266,39 @@ static void raw_hid_task(void) {
  * Console
  ******************************************************************************/
 #ifdef CONSOLE_ENABLE
+static console_buffer_t console_buffer;
+static uint16_t         console_flush_timer;
+
 /** \brief Console Task
  *
- * FIXME: Needs doc
+ * Sends buffered console output a packet at a time while the endpoint is free.
+ * A packet that isn't full yet goes out once it has waited CONSOLE_FLUSH_INTERVAL.
+ * Keyboards with their own main() call it every loop, next to USB_USBTask().
  */
-static void Console_Task(void) {
+void Console_Task(void) {
     /* Device must be connected and configured for the task to run */
     if (USB_DeviceState != DEVICE_STATE_Configured) return;
 
-    uint8_t ep = Endpoint_GetCurrentEndpoint();
-
-#    if 0
-    // TODO: impl receivechar()/recvchar()
-    Endpoint_SelectEndpoint(CONSOLE_OUT_EPNUM);
-
-    /* Check to see if a packet has been sent from the host */
-    if (Endpoint_IsOUTReceived())
-    {
-        /* Check to see if the packet contains data */
-        if (Endpoint_IsReadWriteAllowed())
-        {
-            /* Create a temporary buffer to hold the read in report from the host */
-            uint8_t ConsoleData[CONSOLE_EPSIZE];
-
-            /* Read Console Report Data */
-            Endpoint_Read_Stream_LE(&ConsoleData, sizeof(ConsoleData), NULL);
-
-            /* Process Console Report Data */
-            //ProcessConsoleHIDReport(ConsoleData);
-        }
-
-        /* Finalize the stream transfer to send the last packet */
-        Endpoint_ClearOUT();
-    }
-#    endif
-
-    /* IN packet */
-    Endpoint_SelectEndpoint(CONSOLE_IN_EPNUM);
-    if (!Endpoint_IsEnabled() || !Endpoint_IsConfigured()) {
-        Endpoint_SelectEndpoint(ep);
+    uint16_t count;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { count = console_buffer_count(&console_buffer); }
+    if (!count) {
+        console_flush_timer = timer_read();
         return;
     }
+    if (count < CONSOLE_EPSIZE && timer_elapsed(console_flush_timer) < CONSOLE_FLUSH_INTERVAL) return;
 
-    // fill empty bank
-    while (Endpoint_IsReadWriteAllowed()) Endpoint_Write_8(0);
-
-    // flush sendchar packet
-    if (Endpoint_IsINReady()) {
+    uint8_t ep = Endpoint_GetCurrentEndpoint();
+    Endpoint_SelectEndpoint(CONSOLE_IN_EPNUM);
+    if (Endpoint_IsEnabled() && Endpoint_IsConfigured() && Endpoint_IsINReady()) {
+        // hid_listen prints up to the first zero, so a short packet is padded with them
+        uint8_t data[CONSOLE_EPSIZE] = {0};
+        uint8_t size;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { size = console_buffer_peek(&console_buffer, data, sizeof(data)); }
+        Endpoint_Write_Stream_LE(data, sizeof(data), NULL);
         Endpoint_ClearIN();
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { console_buffer_skip(&console_buffer, size); }
+        console_flush_timer = timer_read();
     }
-
     Endpoint_SelectEndpoint(ep);
 }
 #endif
@@ -391,7 +387,6 @@ void EVENT_USB_Device_Connect(void) {
     if (!USB_IsInitialized) {
         USB_Disable();
         USB_Init();
-        USB_Device_EnableSOFEvents();
     }
 }
 
@@ -446,30 +441,6 @@ void EVENT_USB_Device_WakeUp() {
 #endif
 }
 
-#ifdef CONSOLE_ENABLE
-static bool console_flush = false;
-#    define CONSOLE_FLUSH_SET(b)                                     \
-        do {                                                         \
-            ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { console_flush = b; } \
-        } while (0)
-
-/** \brief Event USB Device Start Of Frame
- *
- * FIXME: Needs doc
- * called every 1ms
- */
-void EVENT_USB_Device_StartOfFrame(void) {
-    static uint8_t count;
-    if (++count % 50) return;
-    count = 0;
-
-    if (!console_flush) return;
-    Console_Task();
-    console_flush = false;
-}
-
-#endif
-
 /** \brief Event handler for the USB_ConfigurationChanged event.
  *
  * This is fired when the host sets the current configuration of the USB device after enumeration.
@@ -480,6 +451,18 @@ void EVENT_USB_Device_StartOfFrame(void) {
 void EVENT_USB_Device_ConfigurationChanged(void) {
     bool ConfigSuccess = true;
 
+    /* Drop reports meant for the previous configuration */
+    report_queue_init(&keyboard_queue, false);
+#ifdef NKRO_ENABLE
+    report_queue_init(&nkro_queue, true);
+#endif
+#ifdef SHARED_EP_ENABLE
+    report_scheduler_init(&shared_scheduler);
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    report_scheduler_init(&mouse_scheduler);
+#endif
+
 #ifndef KEYBOARD_SHARED_EP
     /* Setup keyboard report endpoint */
     ConfigSuccess &= Endpoint_ConfigureEndpoint((KEYBOARD_IN_EPNUM | ENDPOINT_DIR_IN), EP_TYPE_INTERRUPT, KEYBOARD_EPSIZE, 1);
@@ -559,8 +542,8 @@ void EVENT_USB_Device_ControlRequest(void) {
                 switch (USB_ControlRequest.wIndex) {
                     case KEYBOARD_INTERFACE:
                         // TODO: test/check
-                        ReportData = (uint8_t *)&keyboard_report_sent;
-                        ReportSize = sizeof(keyboard_report_sent);
+                        ReportData = (uint8_t *)report_queue_newest(&keyboard_queue);
+                        ReportSize = sizeof(report_keyboard_t);
                         break;
                 }
 
@@ -663,13 +646,70 @@ void EVENT_USB_Device_ControlRequest(void) {
  */
 static uint8_t keyboard_leds(void) { return keyboard_led_state; }
 
+/** \brief Send Queued Keyboard Report
+ *
+ * Writes the oldest queued report if the endpoint is free, without waiting for it.
+ */
+static void send_keyboard_queued(report_queue_t *queue, uint8_t ep) {
+    if (report_queue_is_empty(queue)) return;
+
+    Endpoint_SelectEndpoint(ep);
+    if (!Endpoint_IsReadWriteAllowed()) return;
+
+    report_queue_pop(queue);
+    /* If we're in Boot Protocol, don't send any report ID or other funky fields */
+    report_keyboard_t *report = report_queue_sent(queue);
+    uint8_t *          data   = keyboard_protocol ? (uint8_t *)report : &report->mods;
+    uint8_t            size   = keyboard_protocol ? KEYBOARD_REPORT_SIZE : 8;
+#ifdef NKRO_ENABLE
+    if (queue->nkro) size = sizeof(struct nkro_report);
+#endif
+    Endpoint_Write_Stream_LE(data, size, NULL);
+
+    /* Finalize the stream transfer to send the last packet */
+    Endpoint_ClearIN();
+}
+
+/** \brief Send Scheduled Report
+ *
+ * Writes the next system, consumer or mouse report if the endpoint is free, without waiting for it.
+ */
+#if defined(SHARED_EP_ENABLE) || defined(MOUSE_ENABLE)
+static void send_scheduled(report_scheduler_t *scheduler, uint8_t ep) {
+    if (report_scheduler_is_empty(scheduler)) return;
+
+    Endpoint_SelectEndpoint(ep);
+    if (!Endpoint_IsReadWriteAllowed()) return;
+
+    uint8_t size = report_scheduler_pop(scheduler);
+    Endpoint_Write_Stream_LE(report_scheduler_sent(scheduler), size, NULL);
+    Endpoint_ClearIN();
+}
+#endif
+
+/** \brief Keyboard Report Task
+ *
+ * Sends queued reports as the host frees their endpoints, keyboard reports first.
+ * Keyboards with their own main() call it every loop, next to USB_USBTask().
+ */
+void keyboard_report_task(void) {
+    send_keyboard_queued(&keyboard_queue, KEYBOARD_IN_EPNUM);
+#ifdef NKRO_ENABLE
+    send_keyboard_queued(&nkro_queue, SHARED_IN_EPNUM);
+#endif
+#ifdef SHARED_EP_ENABLE
+    send_scheduled(&shared_scheduler, SHARED_IN_EPNUM);
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    send_scheduled(&mouse_scheduler, MOUSE_IN_EPNUM);
+#endif
+}
+
 /** \brief Send Keyboard
  *
  * FIXME: Needs doc
  */
 static void send_keyboard(report_keyboard_t *report) {
-    uint8_t timeout = 255;
-
 #ifdef BLUETOOTH_ENABLE
     if (where_to_send() == OUTPUT_BLUETOOTH) {
 #    ifdef MODULE_ADAFRUIT_BLE
@@ -689,30 +729,24 @@ static void send_keyboard(report_keyboard_t *report) {
 #endif
 
     /* Select the Keyboard Report Endpoint */
-    uint8_t ep   = KEYBOARD_IN_EPNUM;
-    uint8_t size = KEYBOARD_REPORT_SIZE;
+    report_queue_t *queue = &keyboard_queue;
+    uint8_t         ep    = KEYBOARD_IN_EPNUM;
 #ifdef NKRO_ENABLE
     if (keyboard_protocol && keymap_config.nkro) {
-        ep   = SHARED_IN_EPNUM;
-        size = sizeof(struct nkro_report);
+        queue = &nkro_queue;
+        ep    = SHARED_IN_EPNUM;
     }
 #endif
-    Endpoint_SelectEndpoint(ep);
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
-    if (!Endpoint_IsReadWriteAllowed()) return;
-
-    /* If we're in Boot Protocol, don't send any report ID or other funky fields */
-    if (!keyboard_protocol) {
-        Endpoint_Write_Stream_LE(&report->mods, 8, NULL);
-    } else {
-        Endpoint_Write_Stream_LE(report, size, NULL);
+    /* Wait for the host to take a queued report rather than lose a change, for a polling interval around 10ms */
+    uint8_t timeout = 255;
+    while (!report_queue_has_room(queue, report) && timeout--) {
+        _delay_us(40);
+        send_keyboard_queued(queue, ep);
     }
 
-    /* Finalize the stream transfer to send the last packet */
-    Endpoint_ClearIN();
-
-    keyboard_report_sent = *report;
+    /* Queue the report rather than wait for a busy endpoint */
+    if (!report_queue_push(queue, report)) dprint("keyboard report queue full\n");
+    send_keyboard_queued(queue, ep);
 }
 
 /** \brief Send Mouse
@@ -721,8 +755,6 @@ static void send_keyboard(report_keyboard_t *report) {
  */
 static void send_mouse(report_mouse_t *report) {
 #ifdef MOUSE_ENABLE
-    uint8_t timeout = 255;
-
 #    ifdef BLUETOOTH_ENABLE
     if (where_to_send() == OUTPUT_BLUETOOTH) {
 #        ifdef MODULE_ADAFRUIT_BLE
@@ -743,18 +775,15 @@ static void send_mouse(report_mouse_t *report) {
     }
 #    endif
 
-    /* Select the Mouse Report Endpoint */
-    Endpoint_SelectEndpoint(MOUSE_IN_EPNUM);
-
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
-    if (!Endpoint_IsReadWriteAllowed()) return;
-
-    /* Write Mouse Report Data */
-    Endpoint_Write_Stream_LE(report, sizeof(report_mouse_t), NULL);
-
-    /* Finalize the stream transfer to send the last packet */
-    Endpoint_ClearIN();
+    /* Add the movement to the queued report rather than wait for a busy endpoint */
+#    ifdef MOUSE_SHARED_EP
+    report_scheduler_t *scheduler = &shared_scheduler;
+#    else
+    report_scheduler_t *scheduler = &mouse_scheduler;
+#    endif
+    if (!report_scheduler_push_mouse(scheduler, report)) dprint("mouse report queue full\n");
+    /* queued keyboard reports go first */
+    keyboard_report_task();
 #endif
 }
 
@@ -764,19 +793,13 @@ static void send_mouse(report_mouse_t *report) {
  */
 #ifdef EXTRAKEY_ENABLE
 static void send_extra(uint8_t report_id, uint16_t data) {
-    uint8_t timeout = 255;
-
     if (USB_DeviceState != DEVICE_STATE_Configured) return;
 
+    /* Queue the report rather than wait for a busy endpoint */
     report_extra_t r = {.report_id = report_id, .usage = data};
-    Endpoint_SelectEndpoint(SHARED_IN_EPNUM);
-
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
-    if (!Endpoint_IsReadWriteAllowed()) return;
-
-    Endpoint_Write_Stream_LE(&r, sizeof(report_extra_t), NULL);
-    Endpoint_ClearIN();
+    if (!report_scheduler_push_extra(&shared_scheduler, &r)) dprint("extra report queue full\n");
+    /* queued keyboard reports go first */
+    keyboard_report_task();
 }
 #endif
 
@@ -823,66 +846,16 @@ static void send_consumer(uint16_t data) {
  * sendchar
  ******************************************************************************/
 #ifdef CONSOLE_ENABLE
-#    define SEND_TIMEOUT 5
 /** \brief Send Char
  *
- * FIXME: Needs doc
+ * Adds a character to the console output, which Console_Task() sends later.
+ * Never waits for the host, output that doesn't fit in the buffer is dropped.
+ * Also called from the USB event handlers, in the USB interrupt.
  */
 int8_t sendchar(uint8_t c) {
-    // Do not wait if the previous write has timed_out.
-    // Because sendchar() is called so many times, waiting each call causes big lag.
-    // The `timed_out` state is an approximation of the ideal `is_listener_disconnected?` state.
-    static bool timed_out = false;
-
-    // prevents Console_Task() from running during sendchar() runs.
-    // or char will be lost. These two function is mutually exclusive.
-    CONSOLE_FLUSH_SET(false);
-
-    if (USB_DeviceState != DEVICE_STATE_Configured) return -1;
-
-    uint8_t ep = Endpoint_GetCurrentEndpoint();
-    Endpoint_SelectEndpoint(CONSOLE_IN_EPNUM);
-    if (!Endpoint_IsEnabled() || !Endpoint_IsConfigured()) {
-        goto ERROR_EXIT;
-    }
-
-    if (timed_out && !Endpoint_IsReadWriteAllowed()) {
-        goto ERROR_EXIT;
-    }
-
-    timed_out = false;
-
-    uint8_t timeout = SEND_TIMEOUT;
-    while (!Endpoint_IsReadWriteAllowed()) {
-        if (USB_DeviceState != DEVICE_STATE_Configured) {
-            goto ERROR_EXIT;
-        }
-        if (Endpoint_IsStalled()) {
-            goto ERROR_EXIT;
-        }
-        if (!(timeout--)) {
-            timed_out = true;
-            goto ERROR_EXIT;
-        }
-        _delay_ms(1);
-    }
-
-    Endpoint_Write_8(c);
-
-    // send when bank is full
-    if (!Endpoint_IsReadWriteAllowed()) {
-        while (!(Endpoint_IsINReady()))
-            ;
-        Endpoint_ClearIN();
-    } else {
-        CONSOLE_FLUSH_SET(true);
-    }
-
-    Endpoint_SelectEndpoint(ep);
-    return 0;
-ERROR_EXIT:
-    Endpoint_SelectEndpoint(ep);
-    return -1;
+    bool put;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { put = console_buffer_put(&console_buffer, c); }
+    return put ? 0 : -1;
 }
 #endif
 
@@ -1008,9 +981,6 @@ static void setup_usb(void) {
     USB_Disable();
 
     USB_Init();
-
-    // for Console_Task
-    USB_Device_EnableSOFEvents();
 }
 
 /** \brief Main
@@ -1064,9 +1034,16 @@ int main(void) {
             print("[s]");
             while (USB_DeviceState == DEVICE_STATE_Suspended) {
                 suspend_power_down();
+#    ifdef WAKE_KEY_BUFFER_SIZE
+                // scan anyway, the host may wake up by itself
+                if (suspend_wakeup_condition() && USB_Device_RemoteWakeupEnabled) {
+#    else
                 if (USB_Device_RemoteWakeupEnabled && suspend_wakeup_condition()) {
+#    endif
                     USB_Device_SendRemoteWakeup();
+#    ifndef WAKE_KEY_BUFFER_SIZE
                     clear_keyboard();
+#    endif
 
 #    if USB_SUSPEND_WAKEUP_DELAY > 0
                     // Some hubs, kvm switches, and monitors do
@@ -1084,6 +1061,11 @@ int main(void) {
 #endif
 
         keyboard_task();
+        keyboard_report_task();
+
+#ifdef CONSOLE_ENABLE
+        Console_Task();
+#endif
 
 #ifdef MIDI_ENABLE
         MIDI_Device_USBTask(&USB_MIDI_Interface);
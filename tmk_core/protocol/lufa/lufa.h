@@ -53,6 +53,11 @@ extern "C" {
 
 extern host_driver_t lufa_driver;
 
+void keyboard_report_task(void);
+#ifdef CONSOLE_ENABLE
+void Console_Task(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -351,7 +351,11 @@ const USB_Descriptor_Device_t PROGMEM DeviceDescriptor = {
         .Size                   = sizeof(USB_Descriptor_Device_t),
         .Type                   = DTYPE_Device
     },
+#ifdef USB_HIGH_SPEED
+    .USBSpecification           = VERSION_BCD(2, 0, 0),
+#else
     .USBSpecification           = VERSION_BCD(1, 1, 0),
+#endif
 
 #if VIRTSER_ENABLE
     .Class                      = USB_CSCP_IADDeviceClass,
@@ -378,6 +382,25 @@ const USB_Descriptor_Device_t PROGMEM DeviceDescriptor = {
     .NumberOfConfigurations     = FIXED_NUM_CONFIGURATIONS
 };
 
+#ifdef USB_HIGH_SPEED
+/*
+ * Device qualifier descriptor, required of high speed capable devices
+ */
+const USB_Descriptor_DeviceQualifier_t PROGMEM DeviceQualifierDescriptor = {
+    .Header = {
+        .Size                   = sizeof(USB_Descriptor_DeviceQualifier_t),
+        .Type                   = DTYPE_DeviceQualifier
+    },
+    .USBSpecification           = VERSION_BCD(2, 0, 0),
+    .Class                      = USB_CSCP_NoDeviceClass,
+    .SubClass                   = USB_CSCP_NoDeviceSubclass,
+    .Protocol                   = USB_CSCP_NoDeviceProtocol,
+    .Endpoint0Size              = FIXED_CONTROL_ENDPOINT_SIZE,
+    .NumberOfConfigurations     = FIXED_NUM_CONFIGURATIONS,
+    .Reserved                   = 0
+};
+#endif
+
 #ifndef USB_MAX_POWER_CONSUMPTION
 #    define USB_MAX_POWER_CONSUMPTION 500
 #endif
@@ -386,6 +409,44 @@ const USB_Descriptor_Device_t PROGMEM DeviceDescriptor = {
 #    define USB_POLLING_INTERVAL_MS 10
 #endif
 
+/* Per interface polling intervals, in microseconds */
+#ifndef KEYBOARD_POLLING_INTERVAL_US
+#    define KEYBOARD_POLLING_INTERVAL_US (USB_POLLING_INTERVAL_MS * 1000UL)
+#endif
+#ifndef MOUSE_POLLING_INTERVAL_US
+#    define MOUSE_POLLING_INTERVAL_US (USB_POLLING_INTERVAL_MS * 1000UL)
+#endif
+#ifndef SHARED_POLLING_INTERVAL_US
+#    define SHARED_POLLING_INTERVAL_US (USB_POLLING_INTERVAL_MS * 1000UL)
+#endif
+#ifndef JOYSTICK_POLLING_INTERVAL_US
+#    define JOYSTICK_POLLING_INTERVAL_US (USB_POLLING_INTERVAL_MS * 1000UL)
+#endif
+
+#ifdef USB_HIGH_SPEED
+#    ifndef PROTOCOL_CHIBIOS
+#        error "USB_HIGH_SPEED is only supported on ChibiOS"
+#    endif
+#    if defined(VIRTSER_ENABLE) || defined(MIDI_ENABLE)
+#        error "USB_HIGH_SPEED does not support the bulk endpoints of VIRTSER_ENABLE or MIDI_ENABLE"
+#    endif
+#endif
+
+/*
+ * Full speed endpoints are polled every bInterval frames of 1ms, from 1 to 255.
+ * High speed endpoints are polled every 2^(bInterval - 1) microframes of 125us,
+ * so the interval is rounded down to a power of two.
+ */
+#ifdef USB_HIGH_SPEED
+#    define USB_POLLING_INTERVAL(us)                                                                                              \
+        ((us) >= 125UL << 15 ? 16 : (us) >= 125UL << 14 ? 15 : (us) >= 125UL << 13 ? 14 : (us) >= 125UL << 12 ? 13 :             \
+         (us) >= 125UL << 11 ? 12 : (us) >= 125UL << 10 ? 11 : (us) >= 125UL << 9 ? 10 : (us) >= 125UL << 8 ? 9 :                \
+         (us) >= 125UL << 7 ? 8 : (us) >= 125UL << 6 ? 7 : (us) >= 125UL << 5 ? 6 : (us) >= 125UL << 4 ? 5 :                     \
+         (us) >= 125UL << 3 ? 4 : (us) >= 125UL << 2 ? 3 : (us) >= 125UL << 1 ? 2 : 1)
+#else
+#    define USB_POLLING_INTERVAL(us) ((us) < 1000 ? 1 : (us) > 255000UL ? 255 : (us) / 1000)
+#endif
+
 /*
  * Configuration descriptors
  */
@@ -438,7 +499,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_IN | KEYBOARD_IN_EPNUM),
         .Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = KEYBOARD_EPSIZE,
-        .PollingIntervalMS      = USB_POLLING_INTERVAL_MS
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(KEYBOARD_POLLING_INTERVAL_US)
     },
 #endif
 
@@ -478,7 +539,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_IN | RAW_IN_EPNUM),
         .Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = RAW_EPSIZE,
-        .PollingIntervalMS      = 0x01
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(1000)
     },
     .Raw_OUTEndpoint = {
         .Header = {
@@ -488,7 +549,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_OUT | RAW_OUT_EPNUM),
         .Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = RAW_EPSIZE,
-        .PollingIntervalMS      = 0x01
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(1000)
     },
 #endif
 
@@ -528,7 +589,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_IN | MOUSE_IN_EPNUM),
         .Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = MOUSE_EPSIZE,
-        .PollingIntervalMS      = USB_POLLING_INTERVAL_MS
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(MOUSE_POLLING_INTERVAL_US)
     },
 #endif
 
@@ -573,7 +634,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_IN | SHARED_IN_EPNUM),
         .Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = SHARED_EPSIZE,
-        .PollingIntervalMS      = USB_POLLING_INTERVAL_MS
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(SHARED_POLLING_INTERVAL_US)
     },
 #endif
 
@@ -613,7 +674,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_IN | CONSOLE_IN_EPNUM),
         .Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = CONSOLE_EPSIZE,
-        .PollingIntervalMS      = 0x01
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(1000)
     },
     .Console_OUTEndpoint = {
         .Header = {
@@ -623,7 +684,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_OUT | CONSOLE_OUT_EPNUM),
         .Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = CONSOLE_EPSIZE,
-        .PollingIntervalMS      = 0x01
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(1000)
     },
 #endif
 
@@ -744,7 +805,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
             .EndpointAddress    = (ENDPOINT_DIR_OUT | MIDI_STREAM_OUT_EPNUM),
             .Attributes         = (EP_TYPE_BULK | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
             .EndpointSize       = MIDI_STREAM_EPSIZE,
-            .PollingIntervalMS  = 0x05
+            .PollingIntervalMS  = USB_POLLING_INTERVAL(5000)
         },
         .Refresh                = 0,
         .SyncEndpointNumber     = 0
@@ -767,7 +828,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
             .EndpointAddress    = (ENDPOINT_DIR_IN | MIDI_STREAM_IN_EPNUM),
             .Attributes         = (EP_TYPE_BULK | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
             .EndpointSize       = MIDI_STREAM_EPSIZE,
-            .PollingIntervalMS  = 0x05
+            .PollingIntervalMS  = USB_POLLING_INTERVAL(5000)
         },
         .Refresh                = 0,
         .SyncEndpointNumber     = 0
@@ -845,7 +906,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_IN | CDC_NOTIFICATION_EPNUM),
         .Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = CDC_NOTIFICATION_EPSIZE,
-        .PollingIntervalMS      = 0xFF
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(255000)
     },
     .CDC_DCI_Interface = {
         .Header = {
@@ -868,7 +929,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_OUT | CDC_OUT_EPNUM),
         .Attributes             = (EP_TYPE_BULK | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = CDC_EPSIZE,
-        .PollingIntervalMS      = 0x05
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(5000)
     },
     .CDC_DataInEndpoint = {
         .Header = {
@@ -878,7 +939,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_IN | CDC_IN_EPNUM),
         .Attributes             = (EP_TYPE_BULK | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = CDC_EPSIZE,
-        .PollingIntervalMS      = 0x05
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(5000)
     },
 #endif
 
@@ -918,7 +979,7 @@ const USB_Descriptor_Configuration_t PROGMEM ConfigurationDescriptor = {
         .EndpointAddress        = (ENDPOINT_DIR_IN | JOYSTICK_IN_EPNUM),
         .Attributes             = (EP_TYPE_INTERRUPT | ENDPOINT_ATTR_NO_SYNC | ENDPOINT_USAGE_DATA),
         .EndpointSize           = JOYSTICK_EPSIZE,
-        .PollingIntervalMS      = USB_POLLING_INTERVAL_MS
+        .PollingIntervalMS      = USB_POLLING_INTERVAL(JOYSTICK_POLLING_INTERVAL_US)
     }
 #endif
 };
@@ -986,6 +1047,13 @@ uint16_t get_usb_descriptor(const uint16_t wValue, const uint16_t wIndex, const
             Size    = sizeof(USB_Descriptor_Configuration_t);
 
             break;
+#ifdef USB_HIGH_SPEED
+        case DTYPE_DeviceQualifier:
+            Address = &DeviceQualifierDescriptor;
+            Size    = sizeof(USB_Descriptor_DeviceQualifier_t);
+
+            break;
+#endif
         case DTYPE_String:
             switch (DescriptorIndex) {
                 case 0x00: